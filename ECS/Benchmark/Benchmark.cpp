@@ -0,0 +1,100 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+/* Benchmark runner, results are written as JSON to stdout or to file given by --json,
+   usage: ECSBenchmark [--filter <substring>] [--iterations <count>] [--json <file>] */
+
+namespace
+{
+	struct Result
+	{
+		std::string Name;
+		std::size_t Iterations = 0u;
+		double Mean = 0.0;
+		double Min = 0.0;
+		double Max = 0.0;
+		std::size_t Items = 0u;
+	};
+
+	void WriteJson(std::ostream& stream, const std::vector<Result>& results)
+	{
+		stream << "{\n";
+		stream << "  \"context\": {\n";
+		stream << "    \"library\": \"ECS\",\n";
+#if defined(NDEBUG)
+		stream << "    \"build_type\": \"release\",\n";
+#else
+		stream << "    \"build_type\": \"debug\",\n";
+#endif
+		stream << "    \"entities\": " << ecs::benchmark::EntitiesCount << "\n";
+		stream << "  },\n";
+		stream << "  \"benchmarks\": [";
+		for (std::size_t index = 0; index < results.size(); ++index)
+		{
+			const auto& result = results[index];
+			const auto itemsPerSecond = (result.Mean > 0.0) ? static_cast<double>(result.Items) / (result.Mean / 1000.0) : 0.0;
+			stream << (index ? ",\n" : "\n");
+			stream << "    {\n";
+			stream << "      \"name\": \"" << result.Name << "\",\n";
+			stream << "      \"iterations\": " << result.Iterations << ",\n";
+			stream << "      \"mean_ms\": " << result.Mean << ",\n";
+			stream << "      \"min_ms\": " << result.Min << ",\n";
+			stream << "      \"max_ms\": " << result.Max << ",\n";
+			stream << "      \"items\": " << result.Items << ",\n";
+			stream << "      \"items_per_second\": " << itemsPerSecond << "\n";
+			stream << "    }";
+		}
+		stream << "\n  ]\n}\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	std::string json;
+	std::size_t iterations = 10u;
+	for (int index = 1; index + 1 < argc; index += 2)
+	{
+		const std::string argument = argv[index];
+		if (argument == "--filter")
+			filter = argv[index + 1];
+		else if (argument == "--iterations")
+			iterations = (std::max)(std::stoul(argv[index + 1]), 1ul);
+		else if (argument == "--json")
+			json = argv[index + 1];
+	}
+
+	std::vector<Result> results;
+	for (const auto& benchmark : ecs::benchmark::GetCases())
+	{
+		if (!filter.empty() && benchmark.Name.find(filter) == std::string::npos)
+			continue;
+
+		Result result;
+		result.Name = benchmark.Name;
+		result.Iterations = iterations;
+		for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+		{
+			ecs::benchmark::Timer timer;
+			benchmark.Body(timer);
+			const auto elapsed = timer.GetMilliseconds();
+			result.Mean += elapsed / static_cast<double>(iterations);
+			result.Min = iteration ? (std::min)(result.Min, elapsed) : elapsed;
+			result.Max = (std::max)(result.Max, elapsed);
+			result.Items = timer.GetItems();
+		}
+		std::cerr << result.Name << ": " << result.Mean << " ms (min " << result.Min << " ms)\n";
+		results.push_back(result);
+	}
+
+	if (json.empty())
+		WriteJson(std::cout, results);
+	else
+	{
+		std::ofstream stream(json);
+		WriteJson(stream, results);
+	}
+	return 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <string>
+#include "ECS.h"
+
+namespace ecs::benchmark
+{
+	/* Benchmark timer, only code between Start and Stop is measured */
+	class Timer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+	public:
+		void Start() { m_Start = Clock::now(); }
+		void Stop() { m_Elapsed += Clock::now() - m_Start; }
+		/* Set count of processed items in one iteration */
+		void SetItems(const std::size_t& items) { m_Items = items; }
+		/* Return measured time in milliseconds */
+		double GetMilliseconds() const { return std::chrono::duration<double, std::milli>(m_Elapsed).count(); }
+		std::size_t GetItems() const { return m_Items; }
+	private:
+		Clock::time_point m_Start;
+		Clock::duration m_Elapsed = Clock::duration::zero();
+		std::size_t m_Items = 0u;
+	};
+	/* Benchmark function, called once per iteration */
+	using Function = void(*)(Timer&);
+	/* Registered benchmark */
+	struct Case
+	{
+		std::string Name;
+		Function Body;
+	};
+	/* Return all registered benchmarks */
+	inline std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+	/* Register benchmark on static initialization */
+	struct Registrar
+	{
+		Registrar(const char* name, Function body) { GetCases().push_back({ name, body }); }
+	};
+	/* Count of entities used by most benchmarks */
+	inline constexpr std::size_t EntitiesCount = 1000000u;
+
+	struct Position { float X, Y, Z; };
+	struct Velocity { float X, Y, Z; };
+	struct Mass { float Value; };
+	struct Health { int Value; };
+}
+
+/* Define and register benchmark */
+#define ECS_BENCHMARK(Name) \
+	static void Name(ecs::benchmark::Timer& timer); \
+	static const ecs::benchmark::Registrar Name##Registrar(#Name, Name); \
+	static void Name(ecs::benchmark::Timer& timer)
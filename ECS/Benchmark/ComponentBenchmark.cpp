@@ -0,0 +1,176 @@
+#include <random>
+#include "Benchmark.h"
+
+/* Adding and removing components */
+
+using namespace ecs::benchmark;
+
+namespace
+{
+	/* Position which lives in its own block */
+	struct StablePosition
+	{
+		float X, Y, Z;
+	};
+}
+
+namespace ecs
+{
+	template<>
+	struct ComponentTraits<StablePosition>
+	{
+		static constexpr bool StableReferences = true;
+		static constexpr bool TrackChanges = false;
+	};
+}
+
+ECS_BENCHMARK(AddComponent)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Start();
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).AddComponent<Position>(0.f, 0.f, 0.f);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(AddComponentBatch)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Start();
+	manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 0.f, 0.f, 0.f });
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(AddThreeComponents)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Start();
+	for (const auto& entity : entities)
+	{
+		ecs::Entity handle(entity, &manager);
+		handle.AddComponent<Position>(0.f, 0.f, 0.f);
+		handle.AddComponent<Velocity>(0.f, 0.f, 0.f);
+		handle.AddComponent<Mass>(1.f);
+	}
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(AddStableComponent)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Start();
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).AddComponent<StablePosition>(0.f, 0.f, 0.f);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(RemoveComponent)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend());
+	timer.Start();
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).RemoveComponent<Position>();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(GetComponent)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend());
+	timer.Start();
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).GetComponent<Position>().X += 1.f;
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+/* Access which checks version of handle, safe in release builds */
+ECS_BENCHMARK(TryGetComponent)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend());
+	timer.Start();
+	for (const auto& entity : entities)
+	{
+		if (auto position = ecs::Entity(entity, &manager).TryGet<Position>())
+			position->X += 1.f;
+	}
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+namespace
+{
+	/* Fill manager with positions of random depth */
+	void InsertRandomPositions(ecs::EntityManager& manager, std::vector<ecs::EntityID>& entities)
+	{
+		std::mt19937 random(42u);
+		std::uniform_real_distribution<float> depth(0.f, 1000.f);
+		manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+		std::vector<Position> positions(EntitiesCount);
+		for (auto& position : positions)
+			position.Z = depth(random);
+		manager.Insert<Position>(entities.cbegin(), entities.cend(), positions.cbegin());
+	}
+	bool CompareDepth(const Position& left, const Position& right) { return left.Z < right.Z; }
+}
+
+ECS_BENCHMARK(SortComponents)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	InsertRandomPositions(manager, entities);
+	timer.Start();
+	manager.Sort<Position>(CompareDepth);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+/* Sort of pool where 1% of components changed after previous sort, like sorting once per frame */
+ECS_BENCHMARK(ResortComponents)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	InsertRandomPositions(manager, entities);
+	manager.Sort<Position>(CompareDepth);
+	std::mt19937 random(7u);
+	for (std::size_t index = 0; index < EntitiesCount / 100u; ++index)
+		ecs::Entity(entities[random() % EntitiesCount], &manager).GetComponent<Position>().Z += 0.01f;
+	timer.Start();
+	manager.Sort<Position>(CompareDepth);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(SortComponentsAs)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	InsertRandomPositions(manager, entities);
+	manager.Insert<Velocity>(entities.crbegin(), entities.crend());
+	manager.Sort<Position>(CompareDepth);
+	timer.Start();
+	manager.SortAs<Velocity, Position>();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
@@ -0,0 +1,92 @@
+#include "Benchmark.h"
+
+/* Entity creation and destruction */
+
+using namespace ecs::benchmark;
+
+ECS_BENCHMARK(CreateEntities)
+{
+	ecs::EntityManager manager;
+	timer.Start();
+	for (std::size_t index = 0; index < EntitiesCount; ++index)
+		manager.CreateEntity();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(CreateEntitiesBatch)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	entities.reserve(EntitiesCount);
+	timer.Start();
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(RecycleEntities)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).Destroy();
+	timer.Start();
+	for (std::size_t index = 0; index < EntitiesCount; ++index)
+		manager.CreateEntity();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(DestroyEntities)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Start();
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).Destroy();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(DestroyEntitiesWithComponents)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend());
+	manager.Insert<Velocity>(entities.cbegin(), entities.cend());
+	manager.Insert<Mass>(entities.cbegin(), entities.cend());
+	timer.Start();
+	for (const auto& entity : entities)
+		ecs::Entity(entity, &manager).Destroy();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(DestroyAllEntities)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend());
+	timer.Start();
+	manager.DestroyAllEntites();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(DestroyAllEntitiesArena)
+{
+	std::pmr::monotonic_buffer_resource arena;
+	ecs::EntityManager manager(&arena);
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend());
+	timer.Start();
+	manager.DestroyAllEntites();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
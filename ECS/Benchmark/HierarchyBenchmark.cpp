@@ -0,0 +1,142 @@
+#include "Benchmark.h"
+
+/* Hierarchy operations, each entity is child of entity with index / 4 */
+
+using namespace ecs::benchmark;
+
+namespace
+{
+	constexpr std::size_t Branching = 4u;
+}
+
+ECS_BENCHMARK(AddChild)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	timer.Start();
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.AddChild(child);
+	}
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(RemoveChild)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.AddChild(child);
+	}
+	timer.Start();
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.RemoveChild(child);
+	}
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(TraverseHierarchy)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 1.f, 1.f, 1.f });
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.AddChild(child);
+	}
+	std::vector<ecs::Entity> stack;
+	timer.Start();
+	stack.emplace_back(entities.front(), &manager);
+	while (!stack.empty())
+	{
+		ecs::Entity entity = stack.back();
+		stack.pop_back();
+		const auto& position = entity.GetComponent<Position>();
+		for (auto& child : entity)
+		{
+			child.GetComponent<Position>().X += position.X;
+			stack.push_back(child);
+		}
+	}
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(TraverseHierarchyBreadthFirst)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 1.f, 1.f, 1.f });
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.AddChild(child);
+	}
+	timer.Start();
+	ecs::Entity(entities.front(), &manager).EachBreadthFirst([](ecs::Entity& entity)
+		{
+			if (entity.HasParent())
+				entity.GetComponent<Position>().X += entity.GetParent().GetComponent<Position>().X;
+		});
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(HierarchyEach)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 1.f, 1.f, 1.f });
+	manager.Insert<Velocity>(entities.cbegin(), entities.cend());
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.AddChild(child);
+	}
+	/* First pass builds cached order */
+	const auto propagate = [](ecs::Entity&, const Position& local, Velocity& world, const Velocity* parent)
+	{
+		world.X = local.X + (parent ? parent->X : 0.f);
+	};
+	manager.HierarchyEach<Position, Velocity>(propagate);
+	timer.Start();
+	manager.HierarchyEach<Position, Velocity>(propagate);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(DestroyWithChildren)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	for (std::size_t index = 1; index < entities.size(); ++index)
+	{
+		ecs::Entity parent(entities[index / Branching], &manager);
+		ecs::Entity child(entities[index], &manager);
+		parent.AddChild(child);
+	}
+	timer.Start();
+	ecs::Entity(entities.front(), &manager).DestroyWithChildren();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
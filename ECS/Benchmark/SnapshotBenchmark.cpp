@@ -0,0 +1,106 @@
+#include <filesystem>
+#include <fstream>
+#include "Benchmark.h"
+
+/* Saving and loading snapshots */
+
+using namespace ecs::benchmark;
+
+namespace
+{
+	/* Manager with two pools of all entities, every fourth entity is destroyed so free list isn't empty */
+	std::string MakeSnapshot()
+	{
+		ecs::EntityManager manager;
+		std::vector<ecs::EntityID> entities;
+		manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+		manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 0.f, 0.f, 0.f });
+		manager.Insert<Velocity>(entities.cbegin(), entities.cend(), Velocity{ 1.f, 1.f, 1.f });
+		for (std::size_t index = 0; index < entities.size(); index += 4u)
+			ecs::Entity(entities[index], &manager).Destroy();
+		std::ostringstream stream(std::ios::binary);
+		ecs::Snapshot::Save(manager, stream);
+		return stream.str();
+	}
+}
+
+ECS_BENCHMARK(SaveSnapshot)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 0.f, 0.f, 0.f });
+	manager.Insert<Velocity>(entities.cbegin(), entities.cend(), Velocity{ 1.f, 1.f, 1.f });
+	std::ostringstream stream(std::ios::binary);
+	timer.Start();
+	ecs::Snapshot::Save(manager, stream);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(LoadSnapshot)
+{
+	static const std::string data = MakeSnapshot();
+	std::istringstream stream(data, std::ios::binary);
+	ecs::EntityManager manager;
+	timer.Start();
+	ecs::Snapshot::Load<Position, Velocity>(manager, stream);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(MapSnapshot)
+{
+	static const std::string path = []()
+		{
+			const auto path = (std::filesystem::temp_directory_path() / "ECSBenchmark.snapshot").string();
+			const auto data = MakeSnapshot();
+			std::ofstream(path, std::ios::binary).write(data.data(), static_cast<std::streamsize>(data.size()));
+			return path;
+		}();
+	ecs::EntityManager manager;
+	timer.Start();
+	ecs::Snapshot::Map<Position, Velocity>(manager, path);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(SaveDelta1)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 0.f, 0.f, 0.f });
+	std::ostringstream previous(std::ios::binary);
+	ecs::Snapshot::Save(manager, previous);
+	const auto data = previous.str();
+	for (std::size_t index = 0; index < entities.size(); index += 100u)
+		ecs::Entity(entities[index], &manager).GetComponent<Position>().X = 1.f;
+	std::ostringstream stream(std::ios::binary);
+	timer.Start();
+	ecs::Snapshot::SaveDelta(manager, data, stream);
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(ApplyDelta1)
+{
+	ecs::EntityManager leader;
+	std::vector<ecs::EntityID> entities;
+	leader.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	leader.Insert<Position>(entities.cbegin(), entities.cend(), Position{ 0.f, 0.f, 0.f });
+	std::ostringstream previous(std::ios::binary);
+	ecs::Snapshot::Save(leader, previous);
+	std::istringstream snapshot(previous.str(), std::ios::binary);
+	ecs::EntityManager follower;
+	ecs::Snapshot::Load<Position>(follower, snapshot);
+	for (std::size_t index = 0; index < entities.size(); index += 100u)
+		ecs::Entity(entities[index], &leader).GetComponent<Position>().X = 1.f;
+	std::ostringstream delta(std::ios::binary);
+	ecs::Snapshot::SaveDelta(leader, previous.str(), delta);
+	std::istringstream stream(delta.str(), std::ios::binary);
+	timer.Start();
+	ecs::Snapshot::ApplyDelta<Position>(follower, stream);
+	timer.Stop();
+	timer.SetItems(EntitiesCount / 100u);
+}
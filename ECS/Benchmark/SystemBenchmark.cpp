@@ -0,0 +1,68 @@
+#include "Benchmark.h"
+
+/* Component update systems */
+
+using namespace ecs::benchmark;
+
+namespace
+{
+	void OnCreatePosition(Position&) {}
+	void OnUpdatePosition(Position& position) { position.X += 1.f; }
+	void OnDestroyPosition(Position&) {}
+
+	ecs::EntityManager& GetWorld()
+	{
+		static std::unique_ptr<ecs::EntityManager> world;
+		if (!world)
+		{
+			world = std::make_unique<ecs::EntityManager>();
+			world->RegisterSystem<Position>(OnCreatePosition, OnUpdatePosition, OnDestroyPosition);
+			std::vector<ecs::EntityID> entities;
+			world->CreateEntities(EntitiesCount, std::back_inserter(entities));
+			world->Insert<Position>(entities.cbegin(), entities.cend());
+		}
+		return *world;
+	}
+	/* Manager with the same update registered as lambda, its body is inlined into the update loop */
+	ecs::EntityManager& GetLambdaWorld()
+	{
+		static std::unique_ptr<ecs::EntityManager> world;
+		if (!world)
+		{
+			world = std::make_unique<ecs::EntityManager>();
+			world->RegisterSystem<Position>(nullptr, [](Position& position) { position.X += 1.f; }, nullptr);
+			std::vector<ecs::EntityID> entities;
+			world->CreateEntities(EntitiesCount, std::back_inserter(entities));
+			world->Insert<Position>(entities.cbegin(), entities.cend());
+		}
+		return *world;
+	}
+}
+
+ECS_BENCHMARK(OnUpdateSystem)
+{
+	auto& world = GetWorld();
+	timer.Start();
+	world.OnUpdateSystem<Position>();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(OnUpdateSystemLambda)
+{
+	auto& world = GetLambdaWorld();
+	timer.Start();
+	world.OnUpdateSystem<Position>();
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+ECS_BENCHMARK(ParallelUpdateSystem)
+{
+	auto& world = GetWorld();
+	world.GetThreadPool();
+	timer.Start();
+	world.ParallelUpdateSystem<Position>({ 16384u, false });
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
@@ -0,0 +1,254 @@
+#include "Benchmark.h"
+
+/* Views with 1, 2 and 4 components at different selectivities, selectivity is share of
+   entities which have all components of the view. Position is present on every entity */
+
+using namespace ecs::benchmark;
+
+namespace
+{
+	/* Position with change tracking */
+	struct TrackedPosition
+	{
+		float X, Y, Z;
+	};
+	/* Position and velocity of physics body, stored by value or in columns */
+	struct Body
+	{
+		float X, Y, Z, VelocityX, VelocityY, VelocityZ;
+	};
+	struct ColumnBody
+	{
+		float X, Y, Z, VelocityX, VelocityY, VelocityZ;
+	};
+}
+
+namespace ecs
+{
+	template<>
+	struct ComponentTraits<TrackedPosition>
+	{
+		static constexpr bool StableReferences = false;
+		static constexpr bool TrackChanges = true;
+	};
+	template<>
+	struct ComponentTraits<ColumnBody>
+	{
+		static constexpr bool StableReferences = false;
+		static constexpr bool TrackChanges = false;
+		static constexpr auto Fields = std::make_tuple(&ColumnBody::X, &ColumnBody::Y, &ColumnBody::Z, &ColumnBody::VelocityX, &ColumnBody::VelocityY, &ColumnBody::VelocityZ);
+	};
+}
+
+namespace
+{
+	/* Return manager where every entity has Position and each 1/stride entity has other components */
+	ecs::EntityManager& GetWorld(const std::size_t& stride)
+	{
+		static std::vector<std::pair<std::size_t, std::unique_ptr<ecs::EntityManager>>> worlds;
+		for (auto& [current, world] : worlds)
+		{
+			if (current == stride)
+				return *world;
+		}
+		auto& world = worlds.emplace_back(stride, std::make_unique<ecs::EntityManager>()).second;
+		for (std::size_t index = 0; index < EntitiesCount; ++index)
+		{
+			ecs::Entity entity = world->CreateEntity();
+			entity.AddComponent<Position>(0.f, 0.f, 0.f);
+			if (index % stride == 0u)
+			{
+				entity.AddComponent<Velocity>(1.f, 1.f, 1.f);
+				entity.AddComponent<Mass>(1.f);
+				entity.AddComponent<Health>(100);
+			}
+		}
+		return *world;
+	}
+
+	template<typename Function>
+	void MeasureView(Timer& timer, const std::size_t& stride, Function function)
+	{
+		auto& world = GetWorld(stride);
+		timer.Start();
+		function(world);
+		timer.Stop();
+		timer.SetItems(EntitiesCount);
+	}
+}
+
+ECS_BENCHMARK(View1Component)
+{
+	MeasureView(timer, 1u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position>().Each([](ecs::Entity&, Position& position) { position.X += 1.f; });
+		});
+}
+
+ECS_BENCHMARK(View2Components100)
+{
+	MeasureView(timer, 1u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity>().Each([](ecs::Entity&, Position& position, Velocity& velocity) { position.X += velocity.X; });
+		});
+}
+
+ECS_BENCHMARK(View2Components50)
+{
+	MeasureView(timer, 2u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity>().Each([](ecs::Entity&, Position& position, Velocity& velocity) { position.X += velocity.X; });
+		});
+}
+
+ECS_BENCHMARK(View2Components10)
+{
+	MeasureView(timer, 10u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity>().Each([](ecs::Entity&, Position& position, Velocity& velocity) { position.X += velocity.X; });
+		});
+}
+
+ECS_BENCHMARK(View4Components100)
+{
+	MeasureView(timer, 1u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity, Mass, Health>().Each([](ecs::Entity&, Position& position, Velocity& velocity, Mass& mass, Health& health)
+				{
+					position.X += velocity.X * mass.Value;
+					health.Value -= 1;
+				});
+		});
+}
+
+ECS_BENCHMARK(View4Components50)
+{
+	MeasureView(timer, 2u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity, Mass, Health>().Each([](ecs::Entity&, Position& position, Velocity& velocity, Mass& mass, Health& health)
+				{
+					position.X += velocity.X * mass.Value;
+					health.Value -= 1;
+				});
+		});
+}
+
+ECS_BENCHMARK(View4Components10)
+{
+	MeasureView(timer, 10u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity, Mass, Health>().Each([](ecs::Entity&, Position& position, Velocity& velocity, Mass& mass, Health& health)
+				{
+					position.X += velocity.X * mass.Value;
+					health.Value -= 1;
+				});
+		});
+}
+
+ECS_BENCHMARK(ViewExclude50)
+{
+	MeasureView(timer, 2u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position>(ecs::Exclude<Velocity>{}).Each([](ecs::Entity&, Position& position)
+				{
+					position.X += 1.f;
+				});
+		});
+}
+
+ECS_BENCHMARK(ViewOptional50)
+{
+	MeasureView(timer, 2u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, ecs::Optional<Velocity>>().Each([](ecs::Entity&, Position& position, Velocity* velocity)
+				{
+					position.X += velocity ? velocity->X : 1.f;
+				});
+		});
+}
+
+/* Previous view path, components are taken by entity through the manager */
+ECS_BENCHMARK(View4ComponentsGetComponent50)
+{
+	MeasureView(timer, 2u, [](ecs::EntityManager& manager)
+		{
+			for (auto& entity : manager.View<Position, Velocity, Mass, Health>())
+			{
+				entity.GetComponent<Position>().X += entity.GetComponent<Velocity>().X * entity.GetComponent<Mass>().Value;
+				entity.GetComponent<Health>().Value -= 1;
+			}
+		});
+}
+
+/* Incremental pass, 1% of tracked components was changed during the tick */
+ECS_BENCHMARK(ViewChanged1)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<TrackedPosition>(entities.cbegin(), entities.cend());
+	manager.Insert<Velocity>(entities.cbegin(), entities.cend(), Velocity{ 1.f, 1.f, 1.f });
+	manager.AdvanceTick();
+	for (std::size_t index = 0; index < entities.size(); index += 100u)
+		ecs::Entity(entities[index], &manager).Patch<TrackedPosition>([](TrackedPosition& position) { position.X = 1.f; });
+	timer.Start();
+	manager.View<TrackedPosition, Velocity>().Changed<TrackedPosition>().Each([](ecs::Entity&, TrackedPosition& position, Velocity& velocity)
+		{
+			position.X += velocity.X;
+		});
+	timer.Stop();
+	timer.SetItems(EntitiesCount / 100u);
+}
+
+/* Integration of bodies stored by value, for comparison with columns */
+ECS_BENCHMARK(ViewBodyEach)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<Body>(entities.cbegin(), entities.cend(), Body{ 0.f, 0.f, 0.f, 1.f, 2.f, 3.f });
+	timer.Start();
+	manager.View<Body>().Each([](ecs::Entity&, Body& body)
+		{
+			body.X += body.VelocityX * 0.016f;
+			body.Y += body.VelocityY * 0.016f;
+			body.Z += body.VelocityZ * 0.016f;
+		});
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+/* Integration of bodies stored in columns, loop over spans is vectorized by compiler */
+ECS_BENCHMARK(ViewBodyColumns)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(EntitiesCount, std::back_inserter(entities));
+	manager.Insert<ColumnBody>(entities.cbegin(), entities.cend(), ColumnBody{ 0.f, 0.f, 0.f, 1.f, 2.f, 3.f });
+	timer.Start();
+	manager.View<ColumnBody>().EachChunk([](ecs::Span<const ecs::EntityID> entities, auto columns)
+		{
+			const auto [x, y, z, velocityX, velocityY, velocityZ] = columns;
+			for (std::size_t row = 0; row < entities.size(); ++row)
+			{
+				x[row] += velocityX[row] * 0.016f;
+				y[row] += velocityY[row] * 0.016f;
+				z[row] += velocityZ[row] * 0.016f;
+			}
+		});
+	timer.Stop();
+	timer.SetItems(EntitiesCount);
+}
+
+/* Chunks of two pools in the same order, loop over spans is vectorized by compiler */
+ECS_BENCHMARK(ViewChunk2Components100)
+{
+	MeasureView(timer, 1u, [](ecs::EntityManager& manager)
+		{
+			manager.View<Position, Velocity>().EachChunk([](ecs::Span<const ecs::EntityID> entities, ecs::Span<Position> positions, ecs::Span<Velocity> velocities)
+				{
+					for (std::size_t row = 0; row < entities.size(); ++row)
+						positions[row].X += velocities[row].X;
+				});
+		});
+}
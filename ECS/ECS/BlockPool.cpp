@@ -0,0 +1,29 @@
+#include "BlockPool.h"
+
+ecs::BlockPool::BlockPool(const std::size_t& size, const std::size_t& alignment, std::pmr::memory_resource* resource) :
+	m_Resource(resource), m_Alignment((std::max)(alignment, alignof(FreeBlock))), m_Chunks(resource)
+{
+	/* Each block has to be able to keep link of free list */
+	m_Size = ((std::max)(size, sizeof(FreeBlock)) + m_Alignment - 1u) / m_Alignment * m_Alignment;
+}
+
+void ecs::BlockPool::Release() noexcept
+{
+	for (const auto& chunk : m_Chunks)
+		m_Resource->deallocate(chunk.Data, chunk.Size, m_Alignment);
+	m_Chunks.clear();
+	m_Free = nullptr;
+	m_Capacity = 0u;
+}
+
+void ecs::BlockPool::_Grow()
+{
+	const auto count = m_Chunks.empty() ? FirstChunk : (std::min)(m_Chunks.back().Size / m_Size * 2u, MaxChunk);
+	const auto size = count * m_Size;
+	auto data = static_cast<char*>(m_Resource->allocate(size, m_Alignment));
+	m_Chunks.push_back({ data, size });
+	m_Capacity += size;
+	/* Blocks are linked in address order */
+	for (std::size_t block = count; block; --block)
+		Deallocate(data + (block - 1u) * m_Size);
+}
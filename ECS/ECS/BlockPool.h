@@ -0,0 +1,65 @@
+#pragma once
+#include "Common.h"
+
+namespace ecs
+{
+	/* Pool of fixed size blocks carved from chunks of memory resource, freed blocks are reused first.
+	   Chunks grow geometrically, so count of upstream allocations is logarithmic in count of blocks.
+	   Pool isn't thread safe, it is owned by one component storage */
+	class BlockPool
+	{
+	public:
+		/* Count of blocks in first chunk */
+		static constexpr std::size_t FirstChunk = 64u;
+		/* Max count of blocks in one chunk */
+		static constexpr std::size_t MaxChunk = 65536u;
+	public:
+		BlockPool(const std::size_t& size, const std::size_t& alignment, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		~BlockPool() { Release(); }
+		BlockPool(const BlockPool&) = delete;
+		BlockPool& operator=(const BlockPool&) = delete;
+	public:
+		/* Return uninitialized block */
+		void* Allocate()
+		{
+			if (m_Free == nullptr)
+				_Grow();
+			auto block = m_Free;
+			m_Free = m_Free->Next;
+			return block;
+		}
+		/* Return block to pool, object in block has to be already destroyed */
+		void Deallocate(void* block) noexcept
+		{
+			auto node = static_cast<FreeBlock*>(block);
+			node->Next = m_Free;
+			m_Free = node;
+		}
+		/* Release all chunks at once, all blocks become invalid */
+		void Release() noexcept;
+		/* Return count of bytes taken from memory resource */
+		std::size_t GetCapacity() const noexcept { return m_Capacity; }
+	private:
+		/* Free block keeps link to next free block */
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+		/* Chunk taken from memory resource */
+		struct Chunk
+		{
+			void* Data;
+			std::size_t Size;
+		};
+	private:
+		std::pmr::memory_resource* m_Resource;
+		std::size_t m_Alignment;
+		/* Size of block, multiple of alignment */
+		std::size_t m_Size = 0u;
+		FreeBlock* m_Free = nullptr;
+		std::pmr::vector<Chunk> m_Chunks;
+		std::size_t m_Capacity = 0u;
+	private:
+		void _Grow();
+	};
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include "Storage.h"
+
+namespace ecs
+{
+	namespace internal
+	{
+		/* Alignment of component columns, one cache line, so vectorized loops can use aligned loads from start of column */
+		inline constexpr std::size_t ColumnAlignment = 64u;
+		/* True if component traits list fields of component */
+		template<typename ComponentType, typename = void>
+		struct HasFields : std::false_type {};
+		template<typename ComponentType>
+		struct HasFields<ComponentType, std::void_t<decltype(ComponentTraits<ComponentType>::Fields)>> : std::true_type {};
+		/* True if component is stored as structure of arrays */
+		template<typename ComponentType>
+		inline constexpr bool IsColumnar = HasFields<ComponentType>::value;
+		/* Type of field of member pointer */
+		template<typename Pointer>
+		struct FieldOf;
+		template<typename Class, typename Field>
+		struct FieldOf<Field Class::*> { using Type = Field; };
+		/* Types of columnar storage derived from tuple of member pointers */
+		template<typename Pointers>
+		struct ColumnLayout;
+		template<typename... Pointer>
+		struct ColumnLayout<std::tuple<Pointer...>>
+		{
+			static_assert(sizeof...(Pointer) != 0u, "Component has to list at least one field !");
+			static_assert((!std::is_const_v<typename FieldOf<Pointer>::Type> && ...), "Fields stored in columns can't be const !");
+			/* References to fields of one component */
+			using Reference = std::tuple<typename FieldOf<Pointer>::Type&...>;
+			using ConstReference = std::tuple<const typename FieldOf<Pointer>::Type&...>;
+			/* Rows of each column */
+			using Chunk = std::tuple<Span<typename FieldOf<Pointer>::Type>...>;
+			using ConstChunk = std::tuple<Span<const typename FieldOf<Pointer>::Type>...>;
+			/* Array of each field */
+			using Arrays = std::tuple<PackedArray<typename FieldOf<Pointer>::Type, (std::max)(ColumnAlignment, alignof(typename FieldOf<Pointer>::Type))>...>;
+		};
+	}
+	/* Component storage which keeps each listed field of aggregate component in its own array aligned to ColumnAlignment.
+	   Rows of all columns are in the same order as tightly packed entities, so columns can be handed out as spans to vectorized loops.
+	   Component is accessed as tuple of references to its fields, fields which aren't listed aren't stored.
+	   Components stored in columns can't have systems, stable references or change tracking and they aren't written to snapshots */
+	template<typename ComponentType, typename Entity>
+	class ComponentStorage<ComponentType, Entity, std::enable_if_t<internal::IsColumnar<ComponentType>>> : public Storage<Entity>
+	{
+		friend class EntityManager;
+	private:
+		static_assert(std::is_aggregate_v<ComponentType>, "Only aggregate components can be stored in columns !");
+		static_assert(!internal::IsStable<ComponentType>::value, "Component stored in columns can't have stable references !");
+		static_assert(!internal::IsTracked<ComponentType>::value, "Component stored in columns can't be tracked !");
+		/* Getting acces to storage class */
+		using SetTraits = SparseSet<Entity>;
+		using StorageTraits = Storage<Entity>;
+		using Layout = internal::ColumnLayout<std::remove_const_t<decltype(ComponentTraits<ComponentType>::Fields)>>;
+		using Arrays = typename Layout::Arrays;
+		/* Count of columns */
+		static constexpr std::size_t FieldsCount = std::tuple_size_v<Arrays>;
+	public:
+		using Reference = typename Layout::Reference;
+		using ConstReference = typename Layout::ConstReference;
+		using Chunk = typename Layout::Chunk;
+		using ConstChunk = typename Layout::ConstChunk;
+	public:
+		/* All columns are allocated from resource */
+		explicit ComponentStorage(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : Storage<Entity>(TypeInfo<ComponentType>::ID(), TypeInfo<ComponentType>::Hash(),
+			[](const Entity& entity, Storage<Entity>* storage, BasicSystem* system)
+			{	/* Capture type */
+				static_cast<ComponentStorage<ComponentType, Entity>*>(storage)->Remove(entity, system);
+			}, resource), m_Arrays(_MakeArrays(resource, std::make_index_sequence<FieldsCount>{}))
+		{}
+	public:
+		/* Link component with given id, component is made from arguments and its fields are scattered to columns */
+		template<typename... Args>
+		Reference Add(const Entity& entity, Args&&... args)
+		{
+			assert(!Contains(entity) && "Entity has the component !");
+			const auto component = _Make(std::forward<Args>(args)...);
+			_EachField([&component](auto& array, const auto& field) { array.push_back(component.*field); }, std::make_index_sequence<FieldsCount>{});
+			SetTraits::Push(entity);
+			return GetAt(SetTraits::GetSize() - 1u);
+		}
+		/* Reserve storage for given count of components */
+		void Reserve(const std::size_t& count)
+		{
+			std::apply([&count](auto&... array) { (array.reserve(count), ...); }, m_Arrays);
+			SetTraits::Reserve(count);
+		}
+		/* Unlink component from given id, systems can't be registered for components stored in columns */
+		void Remove(const Entity& entity, BasicSystem* system = nullptr)
+		{
+			assert(Contains(entity) && "Entity doesn't have the component !");
+			assert(system == nullptr && "Component stored in columns can't have system !");
+			(void)system;
+			const auto position = SetTraits::GetPosition(entity);
+			/* Swap with last and pop, keep rows in the same order as tightly packed entities */
+			std::apply([&position](auto&... array) { ((array[position] = array.back(), array.pop_back()), ...); }, m_Arrays);
+			SetTraits::Pop(entity);
+		}
+		/* Get component which linked with given id */
+		Reference Get(const Entity& entity)
+		{
+			assert(Contains(entity) && "Entity doesn't have the component !");
+			return GetAt(SetTraits::GetPosition(entity));
+		}
+		/* Get component by position in tightly packed array */
+		Reference GetAt(const std::size_t& position)
+		{
+			return std::apply([&position](auto&... array) { return Reference(array[position]...); }, m_Arrays);
+		}
+		/* Get const component by position in tightly packed array */
+		ConstReference GetAt(const std::size_t& position) const
+		{
+			return std::apply([&position](const auto&... array) { return ConstReference(array[position]...); }, m_Arrays);
+		}
+		/* Return spans of count rows of each column starting at position in tightly packed array */
+		Chunk GetChunk(const std::size_t& position, const std::size_t& count)
+		{
+			assert(position + count <= SetTraits::GetSize() && "Rows are out of range !");
+			return std::apply([&](auto&... array) { return Chunk(Span(array.data() + position, count)...); }, m_Arrays);
+		}
+		ConstChunk GetChunk(const std::size_t& position, const std::size_t& count) const
+		{
+			assert(position + count <= SetTraits::GetSize() && "Rows are out of range !");
+			return std::apply([&](const auto&... array) { return ConstChunk(Span(array.data() + position, count)...); }, m_Arrays);
+		}
+		/* Return true if id is in storage */
+		bool Contains(const Entity& entity) const { return SetTraits::Contains(entity); }
+		/* Sort entities and rows together, compare takes two tuples of const references to fields */
+		template<typename Compare>
+		void Sort(Compare compare)
+		{
+			SetTraits::_Sort([this, &compare](const std::size_t& left, const std::size_t& right) { return compare(std::as_const(*this).GetAt(left), std::as_const(*this).GetAt(right)); });
+		}
+		/* Sort entities and rows together, compare takes two entities */
+		template<typename Compare>
+		void SortByEntity(Compare compare)
+		{
+			SetTraits::Sort(std::move(compare));
+		}
+		/* Swap two rows by positions in tightly packed array */
+		void Swap(const std::size_t& left, const std::size_t& right) override
+		{
+			std::apply([&](auto&... array) { (std::swap(array[left], array[right]), ...); }, m_Arrays);
+			SetTraits::Swap(left, right);
+		}
+		/* Return memory used by storage */
+		MemoryUsage GetMemoryUsage() const override
+		{
+			auto usage = SetTraits::GetMemoryUsage();
+			usage.Components = std::apply([](const auto&... array) { return ((array.capacity() * sizeof(*array.data())) + ...); }, m_Arrays);
+			return usage;
+		}
+		/* Remove all components at once and release their memory */
+		void Clear(BasicSystem* system) override
+		{
+			assert(system == nullptr && "Component stored in columns can't have system !");
+			(void)system;
+			m_Arrays = _MakeArrays(SetTraits::GetResource(), std::make_index_sequence<FieldsCount>{});
+			SetTraits::Clear();
+		}
+	private:
+		Arrays m_Arrays;
+	private:
+		template<std::size_t... Index>
+		static Arrays _MakeArrays(std::pmr::memory_resource* resource, std::index_sequence<Index...>)
+		{
+			return Arrays(((void)Index, std::tuple_element_t<Index, Arrays>(resource))...);
+		}
+		/* Make component from arguments, aggregate is initialized by braces */
+		template<typename... Args>
+		static ComponentType _Make(Args&&... args)
+		{
+			if constexpr (std::is_constructible_v<ComponentType, Args...>)
+				return ComponentType(std::forward<Args>(args)...);
+			else
+				return ComponentType{ std::forward<Args>(args)... };
+		}
+		/* Execute for each column together with member pointer of its field */
+		template<typename Function, std::size_t... Index>
+		void _EachField(Function function, std::index_sequence<Index...>)
+		{
+			(function(std::get<Index>(m_Arrays), std::get<Index>(ComponentTraits<ComponentType>::Fields)), ...);
+		}
+	};
+}
@@ -0,0 +1,20 @@
+#include "CommandBuffer.h"
+
+void ecs::CommandBuffer::Clear()
+{
+	for (auto& commands : m_Commands)
+	{
+		if (commands)
+			commands->Clear();
+	}
+	m_Destroyed.clear();
+	m_Created = 0u;
+}
+
+bool ecs::CommandBuffer::IsEmpty() const
+{
+	return m_Created == 0u && m_Destroyed.empty() && std::all_of(m_Commands.cbegin(), m_Commands.cend(), [](const auto& commands)
+		{
+			return commands == nullptr || commands->IsEmpty();
+		});
+}
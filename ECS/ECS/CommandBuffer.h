@@ -0,0 +1,165 @@
+#pragma once
+#include <optional>
+#include <iterator>
+#include "Entity.h"
+
+namespace ecs
+{
+	/* Command buffer, records structural changes and plays them back later in one batch.
+	   Buffer isn't thread safe, use one buffer per thread (see ThreadPool::GetWorkerIndex) and flush them together */
+	class CommandBuffer
+	{
+	public:
+		/* Entity which will be created on flush */
+		struct Pending
+		{
+			std::size_t Index;
+		};
+	private:
+		/* Entity handle or index of pending entity */
+		struct Target
+		{
+			EntityID Handle;
+			bool IsPending;
+		};
+		/* Base class of recorded component commands of one type */
+		class BasicCommands
+		{
+		public:
+			virtual ~BasicCommands() = default;
+			/* Apply commands, created contains handles of pending entities */
+			virtual void Apply(EntityManager& manager, const Span<const EntityID>& created) = 0;
+			virtual void Clear() = 0;
+			virtual bool IsEmpty() const = 0;
+		};
+		/* Recorded component commands, component value is empty for remove */
+		template<typename Component>
+		class Commands final : public BasicCommands
+		{
+		public:
+			void Apply(EntityManager& manager, const Span<const EntityID>& created) override
+			{
+				for (auto& [target, component] : m_Commands)
+				{
+					const auto entity = target.IsPending ? created[target.Handle] : target.Handle;
+					if (!manager.IsValidEntity(entity))
+						continue;
+					if (component)
+					{
+						/* Replace component if entity already has it */
+						if (manager.HasComponent<Component>(entity))
+						{
+							manager.GetComponent<Component>(entity) = std::move(*component);
+							manager.MarkChanged<Component>(entity);
+						}
+						else
+							manager.AddComponent<Component>(entity, std::move(*component));
+					}
+					else if (manager.HasComponent<Component>(entity))
+						manager.RemoveComponent<Component>(entity);
+				}
+				Clear();
+			}
+			void Clear() override { m_Commands.clear(); }
+			bool IsEmpty() const override { return m_Commands.empty(); }
+		public:
+			std::vector<std::pair<Target, std::optional<Component>>> m_Commands;
+		};
+	public:
+		CommandBuffer() = default;
+		virtual ~CommandBuffer() = default;
+		CommandBuffer(CommandBuffer&&) = default;
+		CommandBuffer& operator=(CommandBuffer&&) = default;
+	public:
+		/* Record entity creation, returned handle can be used by other commands of this buffer */
+		Pending CreateEntity() { return { m_Created++ }; }
+		/* Record entity destruction */
+		void DestroyEntity(const EntityID& entity) { m_Destroyed.push_back({ entity, false }); }
+		/* Record destruction of pending entity, it is created and destroyed by the same flush */
+		void DestroyEntity(const Pending& entity) { m_Destroyed.push_back({ entity.Index, true }); }
+		/* Record adding of component, component is replaced if entity already has it */
+		template<typename Component, typename... Args>
+		void AddComponent(const EntityID& entity, Args&&... args) { _Add<Component>({ entity, false }, std::forward<Args>(args)...); }
+		/* Record adding of component to pending entity */
+		template<typename Component, typename... Args>
+		void AddComponent(const Pending& entity, Args&&... args) { _Add<Component>({ entity.Index, true }, std::forward<Args>(args)...); }
+		/* Record removing of component */
+		template<typename Component>
+		void RemoveComponent(const EntityID& entity) { _Assure<Component>().m_Commands.emplace_back(Target{ entity, false }, std::nullopt); }
+		/* Record removing of component from pending entity, e.g. to undo earlier add of this buffer */
+		template<typename Component>
+		void RemoveComponent(const Pending& entity) { _Assure<Component>().m_Commands.emplace_back(Target{ entity.Index, true }, std::nullopt); }
+		/* Play back and clear recorded commands */
+		void Flush(EntityManager& manager) { Flush(manager, this, this + 1); }
+		/* Play back and clear commands of several buffers. Pending entities of all buffers are created first in one batch, then component
+		   commands are applied pool by pool in order of recording, destroyed entities are removed last */
+		template<typename Iterator>
+		static void Flush(EntityManager& manager, Iterator first, Iterator last)
+		{
+			/* Handles of pending entities, buffer's entities start at its offset */
+			std::vector<std::size_t> offsets;
+			std::size_t count = 0u;
+			std::size_t types = 0u;
+			for (auto buffer = first; buffer != last; ++buffer)
+			{
+				offsets.push_back(count);
+				count += buffer->m_Created;
+				types = (std::max)(types, buffer->m_Commands.size());
+			}
+			std::vector<EntityID> created;
+			created.reserve(count);
+			manager.CreateEntities(count, std::back_inserter(created));
+			const auto createdOf = [&created, &offsets](auto buffer, const std::size_t& index) { return Span<const EntityID>(created.data() + offsets[index], buffer->m_Created); };
+			for (std::size_t type = 0; type < types; ++type)
+			{
+				std::size_t index = 0;
+				for (auto buffer = first; buffer != last; ++buffer, ++index)
+				{
+					if (type < buffer->m_Commands.size() && buffer->m_Commands[type])
+						buffer->m_Commands[type]->Apply(manager, createdOf(buffer, index));
+				}
+			}
+			std::size_t index = 0;
+			for (auto buffer = first; buffer != last; ++buffer, ++index)
+			{
+				const auto handles = createdOf(buffer, index);
+				for (const auto& target : buffer->m_Destroyed)
+				{
+					const auto entity = target.IsPending ? handles[target.Handle] : target.Handle;
+					if (manager.IsValidEntity(entity))
+						Entity(entity, &manager).Destroy();
+				}
+				buffer->m_Destroyed.clear();
+				buffer->m_Created = 0u;
+			}
+		}
+		/* Drop all recorded commands */
+		void Clear();
+		/* Return true if nothing is recorded */
+		bool IsEmpty() const;
+	private:
+		/* Commands by component type id */
+		std::vector<std::unique_ptr<BasicCommands>> m_Commands;
+		std::vector<Target> m_Destroyed;
+		std::size_t m_Created = 0u;
+	private:
+		template<typename Component>
+		Commands<Component>& _Assure()
+		{
+			static const TypeID index = TypeInfo<Component>::ID();
+			if (!(index < m_Commands.size()))
+				m_Commands.resize(index + 1u);
+			if (m_Commands[index] == nullptr)
+				m_Commands[index] = std::make_unique<Commands<Component>>();
+			return *static_cast<Commands<Component>*>(m_Commands[index].get());
+		}
+		template<typename Component, typename... Args>
+		void _Add(const Target& target, Args&&... args)
+		{
+			if constexpr (std::is_aggregate_v<Component> && !std::is_constructible_v<Component, Args...>)
+				_Assure<Component>().m_Commands.emplace_back(target, Component{ std::forward<Args>(args)... });
+			else
+				_Assure<Component>().m_Commands.emplace_back(std::piecewise_construct, std::forward_as_tuple(target), std::forward_as_tuple(std::in_place, std::forward<Args>(args)...));
+		}
+	};
+}
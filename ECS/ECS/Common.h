@@ -2,23 +2,41 @@
 
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <functional>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <cassert>
 #include <array>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <limits>
+#include <tuple>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <atomic>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace ecs
 {
 	/* Type identifier */
 	using TypeID = std::size_t;
 	/* Type hash value */
-	using TypeHash = std::size_t;
+	using TypeHash = std::uint64_t;
 	/* Entity identifier */
 	using EntityID = std::size_t;
 	/* Entity version  */
 	using EntityVersion = std::size_t;
+	/* Change tracking tick */
+	using Tick = std::uint32_t;
 	/**********************************************/
 	template<typename, typename = void>
 	struct EntityTraits;
@@ -111,14 +129,140 @@ namespace ecs
 
 	inline constexpr Null null{};
 
+	/* Components which entities of view mustn't have, View<A, B>(Exclude<C, D>{}) */
+	template<typename... Component>
+	struct Exclude {};
+	/* Optional component of view, it doesn't restrict view and is passed to function as pointer, nullptr if entity doesn't have it */
+	template<typename Component>
+	struct Optional {};
+
+	/* Non owning view of contiguous elements, e.g. column of components */
+	template<typename T>
+	class Span
+	{
+	public:
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using iterator = T*;
+	public:
+		constexpr Span() noexcept = default;
+		constexpr Span(T* data, const std::size_t& size) noexcept : m_Data(data), m_Size(size) {}
+		/* Span of mutable elements converts to span of const ones */
+		template<typename Other, typename = std::enable_if_t<std::is_convertible_v<Other(*)[], T(*)[]>>>
+		constexpr Span(const Span<Other>& other) noexcept : m_Data(other.data()), m_Size(other.size()) {}
+	public:
+		constexpr T* data() const noexcept { return m_Data; }
+		constexpr std::size_t size() const noexcept { return m_Size; }
+		constexpr bool empty() const noexcept { return m_Size == 0u; }
+		constexpr T& operator[](const std::size_t& position) const noexcept { return m_Data[position]; }
+		constexpr iterator begin() const noexcept { return m_Data; }
+		constexpr iterator end() const noexcept { return m_Data + m_Size; }
+		/* Return count elements starting at offset */
+		constexpr Span subspan(const std::size_t& offset, const std::size_t& count) const noexcept { return Span(m_Data + offset, count); }
+	private:
+		T* m_Data = nullptr;
+		std::size_t m_Size = 0u;
+	};
+
 	namespace internal
 	{
+		/* Maximum count of rows passed to function at once by chunked iteration */
+		inline constexpr std::size_t ChunkSize = 1024u;
+		/* Marks running parallel pass by counter of nested passes, e.g. ParallelEach of system run by scheduler on worker.
+		   Counter is shared by concurrent passes, so it is atomic and each pass only adds and subtracts one */
+		class ParallelPass
+		{
+		public:
+			explicit ParallelPass(std::atomic<std::uint32_t>& depth) noexcept : m_Depth(depth) { ++m_Depth; }
+			~ParallelPass() { --m_Depth; }
+			ParallelPass(const ParallelPass&) = delete;
+			ParallelPass& operator=(const ParallelPass&) = delete;
+		private:
+			std::atomic<std::uint32_t>& m_Depth;
+		};
+		/* Unwrap optional component of view */
+		template<typename Component>
+		struct IsOptional : std::false_type { using Type = Component; };
+		template<typename Component>
+		struct IsOptional<Optional<Component>> : std::true_type { using Type = Component; };
+		template<typename Component>
+		using Unwrap = typename IsOptional<Component>::Type;
+
+		/* Return index of highest set bit, value must not be zero */
+		inline std::size_t HighestBit(const std::uint64_t& value) noexcept
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return static_cast<std::size_t>(index);
+#else
+			return static_cast<std::size_t>(63 - __builtin_clzll(value));
+#endif
+		}
+
+		/* FNV-1a hash of string, 64 bits so it is the same on all platforms */
+		[[nodiscard]] constexpr std::uint64_t Fnv1a(const std::string_view& value) noexcept
+		{
+			std::uint64_t hash = 14695981039346656037ull;
+			for (const auto& character : value)
+			{
+				hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(character));
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+		/* Return position of first ';' or ']' after position which isn't inside of brackets, so template arguments aren't cut */
+		[[nodiscard]] constexpr std::size_t TypeNameEnd(const std::string_view& function, std::size_t position) noexcept
+		{
+			std::size_t depth = 0u;
+			for (; position < function.size(); ++position)
+			{
+				const auto character = function[position];
+				if (character == '<' || character == '(' || character == '[')
+					++depth;
+				else if (depth != 0u && (character == '>' || character == ')' || character == ']'))
+					--depth;
+				else if (depth == 0u && (character == ';' || character == ']'))
+					return position;
+			}
+			return function.rfind(']');
+		}
+		/* Name of type taken from signature of function, works without RTTI */
+		template<typename Type>
+		[[nodiscard]] constexpr std::string_view TypeName() noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			/* "... ecs::internal::TypeName<struct Type>(void) noexcept" */
+			constexpr std::string_view function = __FUNCSIG__;
+			constexpr auto first = function.find("TypeName<") + 9u;
+			constexpr auto last = function.rfind(">(void)");
+			constexpr auto name = function.substr(first, last - first);
+			/* Remove elaborated type specifier, so names match other compilers */
+			if constexpr (name.substr(0u, 7u) == "struct ")
+				return name.substr(7u);
+			else if constexpr (name.substr(0u, 6u) == "class ")
+				return name.substr(6u);
+			else if constexpr (name.substr(0u, 5u) == "enum ")
+				return name.substr(5u);
+			else
+				return name;
+#else
+			/* "... ecs::internal::TypeName() [with Type = Type; ...]" or "... [Type = Type]" */
+			constexpr std::string_view function = __PRETTY_FUNCTION__;
+			constexpr auto first = function.find("Type = ") + 7u;
+			/* GCC appends "; std::string_view = ..." after type, template arguments can contain ';' or ']' as well */
+			constexpr auto last = TypeNameEnd(function, first);
+			return function.substr(first, last - first);
+#endif
+		}
+
 		struct TypeInfo
 		{
+			/* Ids are taken atomically, so types can be used for the first time from several threads */
 			[[nodiscard]] static TypeID Next() noexcept
 			{
-				static TypeID value = 0u;
-				return value++;
+				static std::atomic<TypeID> value{ 0u };
+				return value.fetch_add(1u, std::memory_order_relaxed);
 			}
 		};
 	}
@@ -126,23 +270,21 @@ namespace ecs
 	template<typename Type>
 	struct TypeInfo
 	{
-		/* Get index id of specific type */
+		/* Get global index id of specific type, pools of each manager are indexed by their own dense index */
 		[[nodiscard]] static TypeID ID() noexcept
 		{
-			static TypeID value = internal::TypeInfo::Next();
+			static const TypeID value = internal::TypeInfo::Next();
 			return value;
 		}
-		/* Get hash value of specific type */
-		[[nodiscard]] static TypeHash Hash() noexcept
+		/* Get hash value of specific type, FNV-1a of type name, it is the same across separate builds */
+		[[nodiscard]] static constexpr TypeHash Hash() noexcept
 		{
-			static const TypeHash value = TypeHash(typeid(Type).hash_code());
-			return value;
+			return internal::Fnv1a(Name());
 		}
 		/* Get name of specific type */
-		[[nodiscard]] static const char* Name() noexcept
+		[[nodiscard]] static constexpr std::string_view Name() noexcept
 		{
-			static const auto value = typeid(Type).name();
-			return value;
+			return internal::TypeName<Type>();
 		}
 	};
 }
\ No newline at end of file
@@ -1,3 +1,8 @@
 #pragma once
 #include "EntityManager.h"
-#include "Entity.h"
\ No newline at end of file
+#include "Entity.h"
+#include "View.h"
+#include "Group.h"
+#include "Scheduler.h"
+#include "CommandBuffer.h"
+#include "Snapshot.h"
\ No newline at end of file
@@ -5,35 +5,10 @@ ecs::Entity::Entity(const EntityID& handle, EntityManager* manager) :
 {
 }
 
-ecs::EntityID* ecs::Entity::_ChildrenBegin() noexcept
-{
-	return const_cast<ecs::EntityID*>(const_cast<const ecs::Entity*>(this)->_ChildrenBegin());
-}
-
-ecs::EntityID* ecs::Entity::_ChildrenEnd() noexcept
-{
-	return const_cast<ecs::EntityID*>(const_cast<const ecs::Entity*>(this)->_ChildrenEnd());
-}
-
-const ecs::EntityID* ecs::Entity::_ChildrenBegin() const noexcept
-{
-	assert(IsValid() && " Entity isn't valid !");
-	const auto position = EntityTraits<EntityID>::ToID(m_Handle);
-	auto& children = std::get<2>(m_Manager->m_Entities[position]);
-	return children.data();
-}
-
-const ecs::EntityID* ecs::Entity::_ChildrenEnd() const noexcept
+ecs::EntityID ecs::Entity::_FirstChild() const noexcept
 {
 	assert(IsValid() && " Entity isn't valid !");
-	const auto position = EntityTraits<EntityID>::ToID(m_Handle);
-	auto& children = std::get<2>(m_Manager->m_Entities[position]);
-	return children.data() + children.size();
-}
-
-bool ecs::Entity::IsValid() const
-{
-	return (m_Manager != nullptr && m_Manager->IsValidEntity(m_Handle));
+	return m_Manager->m_Hierarchy.GetFirstChild(m_Handle);
 }
 
 ecs::EntityVersion ecs::Entity::GetVersion() const
@@ -50,16 +25,7 @@ ecs::EntityID ecs::Entity::GetID() const
 void ecs::Entity::Destroy()
 {
 	assert(IsValid() && " Entity isn't valid !");
-	UnsetParent();
-
-	if (HasChildren())
-	{
-		for (auto& child : *this)
-		{
-			m_Manager->RemoveChild(m_Handle, child);
-			m_Manager->SetParent(child, ecs::null);
-		}
-	}
+	/* Manager unlinks entity from its parent and children */
 	m_Manager->DestroyEntity(m_Handle);
 	m_Handle = ecs::null;
 	m_Manager = nullptr;
@@ -69,11 +35,7 @@ void ecs::Entity::DestroyWithChildren()
 {
 	assert(IsValid() && " Entity isn't valid !");
 
-	/* Because we iterate through std::vector::iterator and removing elements we need to avoid issue
-	   with memory shifting after remove an element, because iterator++ increment current pointer after
-	   removing and iterator show wrong element. begin() will always set to next element after remove
-	   previous one. As std::vector is tightly packed, iterator will be automatically set to next element
-	   after std::vector::erase. See EntityManager::RemoveChild */
+	/* Destroying of child unlinks it, so begin() always points to next remaining child */
 	while (begin() != end())
 		begin()->DestroyWithChildren();
 
@@ -88,10 +50,7 @@ void ecs::Entity::AddChild(Entity& child)
 	assert(!m_Manager->HasParent(child) && "Couldn't add child, has allready parent!");
 
 	if (!IsChildOf(child) && !m_Manager->HasParent(child))
-	{
 		m_Manager->AddChild(m_Handle, child);
-		child.SetParent(*this);
-	}
 }
 
 void ecs::Entity::RemoveChild(Entity& child)
@@ -99,15 +58,14 @@ void ecs::Entity::RemoveChild(Entity& child)
 	assert(IsValid() && child.IsValid() && " Entity isn't valid !");
 	assert(*this != child && "Couldn't add child, parent and child are the same!");
 
-	if (m_Manager->RemoveChild(m_Handle, child))
-		child.UnsetParent(true);
-	else assert(false && "Child isn't part of current entitie!");
+	if (!m_Manager->RemoveChild(m_Handle, child))
+		assert(false && "Child isn't part of current entitie!");
 }
 
 void ecs::Entity::RemoveChildren()
 {
-	while (begin() != end())
-		RemoveChild(*begin());
+	assert(IsValid() && " Entity isn't valid !");
+	m_Manager->RemoveChildren(m_Handle);
 }
 
 void ecs::Entity::RemoveAndDestroyChildren()
@@ -115,29 +73,22 @@ void ecs::Entity::RemoveAndDestroyChildren()
 	while (begin() != end())
 	{
 		Entity child = *begin();
-		RemoveChild(*begin());
+		RemoveChild(child);
 		child.Destroy();
 	}
 }
 
 void ecs::Entity::SetParent(Entity& parent)
 {
-	assert(IsValid() && " Entity isn't valid !");
-	if (HasParent())
-	{
-		m_Manager->RemoveChild(parent, m_Handle);
-	}
+	assert(IsValid() && parent.IsValid() && " Entity isn't valid !");
+	assert(*this != parent && "Couldn't set parent, parent and child are the same!");
+	assert(!parent.IsChildOf(*this) && "Couldn't set parent, parent is child of entity!");
 	m_Manager->SetParent(m_Handle, parent);
 }
 
-void ecs::Entity::UnsetParent(const bool& isRecursive)
+void ecs::Entity::UnsetParent()
 {
 	assert(IsValid() && " Entity isn't valid !");
-	auto parent = m_Manager->GetParent(m_Handle);
-	if (HasParent() && !isRecursive)
-	{
-		m_Manager->RemoveChild(parent, m_Handle);
-	}
 	m_Manager->SetParent(m_Handle, ecs::null);
 }
 
@@ -155,12 +106,10 @@ bool ecs::Entity::HasParent() const
 
 bool ecs::Entity::IsChildOf(const Entity& parent) const
 {
-	if (HasParent())
+	/* Walk up through parent links */
+	for (auto current = m_Manager->GetParent(m_Handle); current != ecs::null; current = m_Manager->GetParent(current))
 	{
-		if (GetParent() == parent)
-			return true;
-
-		if (GetParent().IsChildOf(parent))
+		if (current == parent.m_Handle)
 			return true;
 	}
 	return false;
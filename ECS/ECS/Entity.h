@@ -8,47 +8,13 @@ namespace ecs
 	{
 		template<typename Entity, typename... Component>
 		friend class BasicView;
+
+		template<typename Entity, typename... Component>
+		friend class BasicGroup;
 	public:
 		/* Entity iterator to iterate through entities children */
 		template<typename T>
-		class EntityIterator
-		{
-		public:
-			using iterator_category = std::random_access_iterator_tag;
-			using difference_type = std::ptrdiff_t;
-			using value_type = T;
-			using pointer = value_type*;
-			using reference = value_type&;
-		public:
-			EntityIterator(pointer first = nullptr, pointer last = nullptr, EntityManager* manager = nullptr) :
-				m_First(first), m_Last(last), m_Current(first), m_Manager(manager) 
-			{
-				/* Getting entity handle */
-				m_Entity.m_Manager = m_Manager;
-
-				if (m_Current != nullptr)
-					m_Entity.m_Handle = *m_Current;
-			}
-			~EntityIterator() = default;
-		public:
-			EntityIterator& operator++(int) noexcept { ++m_Current; m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			EntityIterator& operator--(int) noexcept { --m_Current; m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			EntityIterator& operator++() noexcept { ++m_Current; m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			EntityIterator& operator--() noexcept { --m_Current; m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			bool operator==(const EntityIterator& other) const noexcept { return other.m_Current == m_Current; }
-			bool operator!=(const EntityIterator& other) const noexcept { return other.m_Current != m_Current; }
-			Entity& operator*() { return m_Entity; }
-			Entity* operator->() { return &m_Entity; }
-			const Entity& operator*() const { return m_Entity; }
-			const Entity* operator->() const { return &m_Entity; }
-			operator bool() const { if (m_Current) return true; else return false; }
-		private:
-			pointer const m_First;
-			pointer const m_Last;
-			pointer m_Current;
-			EntityManager* const m_Manager;
-			Entity m_Entity;
-		};
+		class EntityIterator;
 
 	public:
 		using iterator = EntityIterator<EntityID>;
@@ -59,47 +25,66 @@ namespace ecs
 		Entity(const Entity&) = default;
 	public:
 		/* Begin of children iterator */
-		iterator begin() noexcept { return iterator(_ChildrenBegin(), _ChildrenEnd(), m_Manager); };
+		iterator begin() noexcept;
 		/* End of children iterator */
-		iterator end() noexcept { return iterator(_ChildrenEnd(), _ChildrenEnd(), m_Manager); };
+		iterator end() noexcept;
 		/* Const begin of children iterator */
-		const_iterator cbegin() const noexcept { return const_iterator(_ChildrenBegin(), _ChildrenEnd(), m_Manager); };
+		const_iterator cbegin() const noexcept;
 		/* Const end of children iterator */
-		const_iterator cend() const noexcept { return const_iterator(_ChildrenEnd(), _ChildrenEnd(), m_Manager); };
+		const_iterator cend() const noexcept;
 	public:
-		/* Add component to entity */
+		/* Add component to entity, components stored in columns are returned as tuple of references to their fields */
 		template<typename Component, typename... Args>
-		Component& AddComponent(Args&&... args)
+		decltype(auto) AddComponent(Args&&... args)
 		{
 			assert(IsValid() && " Entity isn't valid !");
-			static const TypeID index = TypeInfo<Component>::ID();
 			return m_Manager->AddComponent<Component>(m_Handle, std::forward<Args>(args)...);
 		}
 		/* Get component from entity */
 		template<typename Component>
-		Component& GetComponent()
+		decltype(auto) GetComponent()
 		{
 			assert(IsValid() && " Entity isn't valid !");
-			static const TypeID index = TypeInfo<Component>::ID();
 			return m_Manager->GetComponent<Component>(m_Handle);
 		}
+		/* Return component of entity, or nullptr if entity was destroyed, its id was recycled or it doesn't have the component.
+		   Unlike GetComponent it checks handle in release builds too */
+		template<typename Component>
+		Component* TryGet() const
+		{
+			return m_Manager ? m_Manager->TryGet<Component>(m_Handle) : nullptr;
+		}
 		/* Remove component from entity */
 		template<typename Component>
 		void RemoveComponent()
 		{
 			assert(IsValid() && " Entity isn't valid !");
-			static const TypeID index = TypeInfo<Component>::ID();
 			m_Manager->RemoveComponent<Component>(m_Handle);
 		}
+		/* Change component in place and mark it as changed during current tick */
+		template<typename Component, typename Function>
+		void Patch(Function function)
+		{
+			assert(IsValid() && " Entity isn't valid !");
+			function(m_Manager->GetComponent<Component>(m_Handle));
+			m_Manager->MarkChanged<Component>(m_Handle);
+		}
+		/* Mark component as changed during current tick, for components changed through reference */
+		template<typename Component>
+		void MarkChanged()
+		{
+			assert(IsValid() && " Entity isn't valid !");
+			m_Manager->MarkChanged<Component>(m_Handle);
+		}
 		/* If entity has given component */
 		template<typename Component>
-		const bool HasComponent() const
+		bool HasComponent() const
 		{
 			assert(IsValid() && " Entity isn't valid !");
 			return m_Manager->HasComponent<Component>(m_Handle);
 		}
-		/* Is entity valid ( id != null and manager != nullptr )*/
-		bool IsValid() const;
+		/* Is entity valid ( id != null and manager != nullptr ), version of handle is compared with entity table */
+		bool IsValid() const { return m_Manager != nullptr && m_Manager->IsValidEntity(m_Handle); }
 		/* Get entity recycled version */
 		EntityVersion GetVersion() const;
 		/* Get entity ID (handle)*/
@@ -118,8 +103,8 @@ namespace ecs
 		void RemoveAndDestroyChildren();
 		/* Set parent for curent entity */
 		void SetParent(Entity& parent);
-		/* Unset parent from entity, bool argument for internal use, keep it as it is */
-		void UnsetParent(const bool& isRecursive = false);
+		/* Unset parent from entity */
+		void UnsetParent();
 		/* Return true if entity has children */
 		bool HasChildren() const;
 		/* Return true if entity has parent */
@@ -128,6 +113,19 @@ namespace ecs
 		bool IsChildOf(const Entity& parent) const;
 		/* Return valid entity if entity has parent, else eniti with unvalid handle */
 		Entity GetParent() const;
+		/* Execute for entity and each of its descendants in breadth-first order, parent is always visited before its children.
+		   Hierarchy can't be changed during traversal */
+		template<typename Function>
+		void EachBreadthFirst(Function function)
+		{
+			assert(IsValid() && " Entity isn't valid !");
+			auto manager = m_Manager;
+			manager->m_Hierarchy.EachBreadthFirst(m_Handle, [manager, &function](const EntityID& handle)
+				{
+					Entity entity(handle, manager);
+					function(entity);
+				});
+		}
 
 		/* Overloaded operator bool */
 		operator bool() const { return IsValid(); }
@@ -146,12 +144,91 @@ namespace ecs
 		/* Convert entity to const std::string */
 		operator const std::string() const { return std::to_string(static_cast<EntityID>(GetID())); }
 	private:
-		EntityID* _ChildrenBegin() noexcept;
-		EntityID* _ChildrenEnd()   noexcept;
-		const EntityID* _ChildrenBegin() const noexcept;
-		const EntityID* _ChildrenEnd()   const noexcept;
+		EntityID _FirstChild() const noexcept;
 	private:
 		EntityID m_Handle;
 		EntityManager* m_Manager;
 	};
+
+	/* Entity iterator to iterate through entities children, follows sibling links of hierarchy */
+	template<typename T>
+	class Entity::EntityIterator
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = T;
+		using pointer = value_type*;
+		using reference = value_type&;
+	public:
+		EntityIterator(const EntityID& current = ecs::null, EntityManager* manager = nullptr) :
+			m_Manager(manager)
+		{
+			m_Entity.m_Handle = current;
+			m_Entity.m_Manager = m_Manager;
+		}
+		~EntityIterator() = default;
+	public:
+		EntityIterator& operator++(int) noexcept { m_Entity.m_Handle = m_Manager->m_Hierarchy.GetNextSibling(m_Entity.m_Handle); return (*this); }
+		EntityIterator& operator--(int) noexcept { m_Entity.m_Handle = m_Manager->m_Hierarchy.GetPrevSibling(m_Entity.m_Handle); return (*this); }
+		EntityIterator& operator++() noexcept { m_Entity.m_Handle = m_Manager->m_Hierarchy.GetNextSibling(m_Entity.m_Handle); return (*this); }
+		EntityIterator& operator--() noexcept { m_Entity.m_Handle = m_Manager->m_Hierarchy.GetPrevSibling(m_Entity.m_Handle); return (*this); }
+		bool operator==(const EntityIterator& other) const noexcept { return other.m_Entity.m_Handle == m_Entity.m_Handle; }
+		bool operator!=(const EntityIterator& other) const noexcept { return other.m_Entity.m_Handle != m_Entity.m_Handle; }
+		Entity& operator*() { return m_Entity; }
+		Entity* operator->() { return &m_Entity; }
+		const Entity& operator*() const { return m_Entity; }
+		const Entity* operator->() const { return &m_Entity; }
+		operator bool() const { if (m_Entity.m_Handle != ecs::null) return true; else return false; }
+	private:
+		EntityManager* const m_Manager;
+		Entity m_Entity;
+	};
+
+	inline Entity::iterator Entity::begin() noexcept { return iterator(_FirstChild(), m_Manager); }
+
+	inline Entity::iterator Entity::end() noexcept { return iterator(ecs::null, m_Manager); }
+
+	inline Entity::const_iterator Entity::cbegin() const noexcept { return const_iterator(_FirstChild(), m_Manager); }
+
+	inline Entity::const_iterator Entity::cend() const noexcept { return const_iterator(ecs::null, m_Manager); }
+
+	template<typename Local, typename World, typename Function>
+	void EntityManager::HierarchyEach(Function function)
+	{
+		const auto locals = _GetPool<Local>();
+		const auto worlds = _GetPool<World>();
+		if (!locals || !worlds)
+			return;
+		const auto world = _GetIndex<World>();
+
+		/* Entities outside of hierarchy don't have parent */
+		for (std::size_t position = 0; position < locals->GetSize(); ++position)
+		{
+			const auto handle = locals->GetData()[position];
+			if (!m_Hierarchy.IsLinked(handle) && _HasComponent(handle, world))
+			{
+				Entity entity(m_Entities[handle], this);
+				function(entity, static_cast<const Local&>(locals->GetAt(position)), worlds->Get(handle), static_cast<const World*>(nullptr));
+			}
+		}
+		/* Position of World component of each entity is kept, so children take parent component without lookup */
+		auto& order = m_Hierarchy.GetOrder();
+		order.Positions.resize(order.Entities.size());
+		for (std::size_t position = 0; position < order.Entities.size(); ++position)
+		{
+			const auto handle = order.Entities[position];
+			const auto local = locals->Find(EntityTraits<EntityID>::ToID(handle));
+			const auto current = (local != SparseSet<EntityID>::Tombstone) ? worlds->Find(EntityTraits<EntityID>::ToID(handle)) : SparseSet<EntityID>::Tombstone;
+			order.Positions[position] = current;
+			if (current == SparseSet<EntityID>::Tombstone)
+				continue;
+
+			const auto parent = order.Parents[position];
+			const World* parentWorld = (parent != Hierarchy<EntityID>::Order::Root && order.Positions[parent] != SparseSet<EntityID>::Tombstone) ?
+				&static_cast<const ComponentStorage<World, EntityID>*>(worlds)->GetAt(order.Positions[parent]) : nullptr;
+			Entity entity(handle, this);
+			function(entity, static_cast<const Local&>(locals->GetAt(local)), worlds->GetAt(current), parentWorld);
+		}
+	}
 }
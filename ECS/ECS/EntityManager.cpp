@@ -6,6 +6,12 @@ ecs::EntityManager::EntityManager(void(*onCreateEntity)(Entity&))
 	m_OnEntityCreate = onCreateEntity;
 }
 
+ecs::EntityManager::EntityManager(std::pmr::memory_resource* resource, void(*onCreateEntity)(Entity&)) :
+	m_Resource(resource), m_Signatures(resource), m_Hierarchy(resource), m_Created(resource), m_Entities(resource)
+{
+	m_OnEntityCreate = onCreateEntity;
+}
+
 ecs::EntityManager::~EntityManager()
 {
 	DestroyAllEntites();
@@ -13,32 +19,56 @@ ecs::EntityManager::~EntityManager()
 
 ecs::Entity ecs::EntityManager::CreateEntity()
 {
-	EntityTraits<EntityID>::EntityType handle;
-	if (m_Destroyed == ecs::null)
-	{
-		handle = std::get<0>(m_Entities.emplace_back(std::tuple<EntityID, EntityID, std::vector<EntityID>>{ EntityTraits<EntityID>::EntityType(static_cast<EntityTraits<EntityID>::EntityType>(m_Entities.size())), ecs::null, {}}));
-	}
-	else
-	{
-		const auto current = EntityTraits<EntityID>::ToIntegral(m_Destroyed);
-		const auto version = EntityTraits<EntityID>::ToIntegral(std::get<0>(m_Entities[current])) & (EntityTraits<EntityID>::VersionMask << EntityTraits<EntityID>::EntityShift);
-
-		m_Destroyed = EntityTraits<EntityID>::EntityType(EntityTraits<EntityID>::ToIntegral(std::get<0>(m_Entities[current])) & EntityTraits<EntityID>::EntityMask);
-		handle = std::get<0>(m_Entities[current]) = EntityTraits<EntityID>::EntityType(current | version);
-		std::get<1>(m_Entities[current]) = ecs::null;
-	}
-
-	Entity entity = Entity(handle, this);
+	assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+	Entity entity = Entity(_CreateHandle(), this);
 	if (m_OnEntityCreate)
 		m_OnEntityCreate(entity);
 
 	return entity;
 }
 
+void ecs::EntityManager::_CreateEntities(const std::size_t& count)
+{
+	assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+	if (count > m_DestroyedCount)
+	{
+		m_Entities.reserve(m_Entities.size() + (count - m_DestroyedCount));
+		m_Signatures.reserve(m_Entities.capacity() * m_SignatureWords);
+	}
+	m_Created.clear();
+	m_Created.reserve(count);
+	for (std::size_t index = 0; index < count; ++index)
+		m_Created.push_back(_CreateHandle());
+
+	if (m_OnEntityCreate)
+	{
+		for (const auto& handle : m_Created)
+		{
+			Entity entity = Entity(handle, this);
+			m_OnEntityCreate(entity);
+		}
+	}
+}
+
 void ecs::EntityManager::DestroyAllEntites()
 {
-	for (auto& entity : *this)
-		DestroyEntity(entity);
+	assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+	for (auto& pool : m_Pools)
+		pool->Clear(pool->m_System);
+	for (auto& group : m_Groups)
+		group->Size = 0u;
+	m_Hierarchy.Clear();
+	std::fill(m_Signatures.begin(), m_Signatures.end(), std::uint64_t(0u));
+	/* Entities are destroyed in the same order as one by one, so the last one is head of free list */
+	for (std::size_t handle = 0; handle < m_Entities.size(); ++handle)
+	{
+		if (EntityTraits<EntityID>::ToID(m_Entities[handle]) != handle)
+			continue;
+		const auto version = EntityTraits<EntityID>::VersionType((EntityTraits<EntityID>::ToIntegral(m_Entities[handle]) >> EntityTraits<EntityID>::EntityShift) + 1);
+		m_Entities[handle] = EntityTraits<EntityID>::EntityType(EntityTraits<EntityID>::ToID(m_Destroyed) | (EntityTraits<EntityID>::ToIntegral(version) << EntityTraits<EntityID>::EntityShift));
+		m_Destroyed = EntityTraits<EntityID>::EntityType(handle);
+		++m_DestroyedCount;
+	}
 }
 
 void ecs::EntityManager::SetOnEntityCreate(void(*function)(Entity&))
@@ -46,80 +76,182 @@ void ecs::EntityManager::SetOnEntityCreate(void(*function)(Entity&))
 	m_OnEntityCreate = function;
 }
 
+ecs::ThreadPool& ecs::EntityManager::GetThreadPool()
+{
+	if (!m_ThreadPool)
+		m_ThreadPool = std::make_unique<ThreadPool>();
+	return *m_ThreadPool;
+}
+
+void ecs::EntityManager::SetThreadsCount(const std::size_t& count)
+{
+	assert(m_ParallelDepth == 0u && "Thread pool can't be changed during parallel pass !");
+	m_ThreadPool = std::make_unique<ThreadPool>(count);
+}
+
 std::size_t ecs::EntityManager::EntitiesCount() const
 {
-	return (m_Destroyed == ecs::null) ? m_Entities.size() : m_Entities.size() - (EntityTraits<EntityID>::ToID(m_Destroyed) + 1);
+	return m_Entities.size() - m_DestroyedCount;
 }
  
-bool ecs::EntityManager::IsValidEntity(const EntityID& entity) const
+void ecs::EntityManager::AdvanceTick()
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	return (entity != ecs::null && position < m_Entities.size() && std::get<0>(m_Entities[position]) == entity);
+	assert(m_ParallelDepth == 0u && "Tick can't be advanced during parallel pass !");
+	for (auto& pool : m_Pools)
+	{
+		if (pool)
+			pool->AdvanceTick();
+	}
+}
+
+std::vector<std::pair<ecs::TypeID, ecs::MemoryUsage>> ecs::EntityManager::GetMemoryReport() const
+{
+	std::vector<std::pair<TypeID, MemoryUsage>> report;
+	for (const auto& pool : m_Pools)
+	{
+		if (pool)
+			report.emplace_back(pool->GetID(), pool->GetMemoryUsage());
+	}
+	return report;
 }
 
 void ecs::EntityManager::DestroyEntity(const EntityID& entity)
 {
+	assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
 	/* Extract id */
-	auto handle = EntityTraits<EntityID>::EntityType(entity) & EntityTraits<EntityID>::EntityMask;
-	/* Extract version */
-	auto version = EntityTraits<EntityID>::VersionType((EntityTraits<EntityID>::ToIntegral(handle) >> EntityTraits<EntityID>::EntityShift) + 1);
-	/* Mark entity as destroyed */
-	std::get<0>(m_Entities[handle]) = EntityTraits<EntityID>::EntityType(EntityTraits<EntityID>::ToIntegral(m_Destroyed) | (EntityTraits<EntityID>::ToIntegral(version) << EntityTraits<EntityID>::EntityShift));
-	m_Destroyed = EntityTraits<EntityID>::EntityType(entity);
-	/* Remove entity from all pools and destroy all related components */
-	for (auto position = m_Pools.size(); position; --position)
+	const auto handle = EntityTraits<EntityID>::ToID(entity);
+	/* Unlink entity from its parent, children are kept alive without parent */
+	m_Hierarchy.Remove(handle);
+	/* Next version, taken from the table because entity could reference the table itself */
+	const auto version = EntityTraits<EntityID>::VersionType((EntityTraits<EntityID>::ToIntegral(m_Entities[handle]) >> EntityTraits<EntityID>::EntityShift) + 1);
+	/* Mark entity as destroyed, entity slot keeps next destroyed id and new version */
+	m_Entities[handle] = EntityTraits<EntityID>::EntityType(EntityTraits<EntityID>::ToID(m_Destroyed) | (EntityTraits<EntityID>::ToIntegral(version) << EntityTraits<EntityID>::EntityShift));
+	m_Destroyed = EntityTraits<EntityID>::EntityType(handle);
+	++m_DestroyedCount;
+	_RemoveComponents(handle);
+}
+
+void ecs::EntityManager::_RemoveComponents(const EntityID& handle)
+{
+	/* Remove entity from pools of its signature and destroy all related components */
+	auto signature = _Signature(handle);
+	for (auto word = m_SignatureWords; word; --word)
 	{
-		if (auto& pData = m_Pools[position - 1]; pData && pData->Contains(handle)) 
+		while (signature[word - 1])
 		{
-			auto system = m_Systems.find(pData->GetID());
-			if (system != m_Systems.end())
-				pData->m_Destroy(handle, pData.get(), system->second.get());
-			else
-				pData->m_Destroy(handle, pData.get(), nullptr);
+			const auto bit = internal::HighestBit(signature[word - 1]);
+			signature[word - 1] &= ~(std::uint64_t(1u) << bit);
+
+			auto& pData = m_Pools[(word - 1) * SignatureBits + bit];
+			if (pData->m_Group)
+				_LeaveGroup(pData->m_Group, handle);
+			pData->m_Destroy(handle, pData.get(), pData->m_System);
 		}
 	}
 }
 
 void ecs::EntityManager::AddChild(const EntityID& entity, const EntityID& child)
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	std::get<2>(m_Entities[position]).emplace_back(child);
+	m_Hierarchy.Link(entity, child);
 }
 
 bool ecs::EntityManager::RemoveChild(const EntityID& entity, const EntityID& child)
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	auto it = std::find(std::get<2>(m_Entities[position]).begin(), std::get<2>(m_Entities[position]).end(), child);
-	if (it != std::get<2>(m_Entities[position]).end())
-	{
-		std::get<2>(m_Entities[position]).erase(it);
-		return true;
-	}
-	return false;
+	if (m_Hierarchy.GetParent(child) != entity)
+		return false;
+	m_Hierarchy.Unlink(child);
+	return true;
+}
+
+void ecs::EntityManager::RemoveChildren(const EntityID& entity)
+{
+	m_Hierarchy.UnlinkChildren(entity);
 }
 
 bool ecs::EntityManager::HasChildren(const EntityID& entity) const
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	return std::get<2>(m_Entities[position]).size();
+	return m_Hierarchy.HasChildren(entity);
 }
 
 ecs::EntityID ecs::EntityManager::GetParent(const EntityID& entity) const
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	return std::get<1>(m_Entities[position]);
+	return m_Hierarchy.GetParent(entity);
 }
 
-bool ecs::EntityManager::HasParent(const EntityID& entity)
+bool ecs::EntityManager::HasParent(const EntityID& entity) const
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	return std::get<1>(m_Entities[position]) != ecs::null;
+	return m_Hierarchy.GetParent(entity) != ecs::null;
 }
 
 void ecs::EntityManager::SetParent(const EntityID& entity, const EntityID& parent)
 {
-	const auto position = EntityTraits<EntityID>::ToID(entity);
-	std::get<1>(m_Entities[position]) = parent;
+	m_Hierarchy.Unlink(entity);
+	if (parent != ecs::null)
+		m_Hierarchy.Link(parent, entity);
+}
+
+void ecs::EntityManager::_ResizeSignatures(const std::size_t& words)
+{
+	std::pmr::vector<std::uint64_t> signatures(m_Entities.size() * words, 0u, m_Resource);
+	for (std::size_t entity = 0; entity < m_Entities.size(); ++entity)
+		std::copy_n(_Signature(entity), m_SignatureWords, signatures.data() + entity * words);
+	m_Signatures = std::move(signatures);
+	m_SignatureWords = words;
+}
+
+ecs::EntityID ecs::EntityManager::_CreateHandle()
+{
+	EntityTraits<EntityID>::EntityType handle;
+	if (m_Destroyed == ecs::null)
+	{
+		handle = m_Entities.emplace_back(EntityTraits<EntityID>::EntityType(static_cast<EntityTraits<EntityID>::EntityType>(m_Entities.size())));
+		m_Signatures.resize(m_Entities.size() * m_SignatureWords, 0u);
+	}
+	else
+	{
+		const auto current = EntityTraits<EntityID>::ToID(m_Destroyed);
+		const auto version = EntityTraits<EntityID>::ToIntegral(m_Entities[current]) & (EntityTraits<EntityID>::VersionMask << EntityTraits<EntityID>::EntityShift);
+
+		m_Destroyed = EntityTraits<EntityID>::EntityType(EntityTraits<EntityID>::ToIntegral(m_Entities[current]) & EntityTraits<EntityID>::EntityMask);
+		handle = m_Entities[current] = EntityTraits<EntityID>::EntityType(current | version);
+		--m_DestroyedCount;
+	}
+	return handle;
+}
+
+void ecs::EntityManager::_EnterGroup(internal::GroupData<EntityID>* group, const EntityID& entity)
+{
+	const auto& pools = group->Pools;
+	if (std::all_of(pools.cbegin(), pools.cend(), [&entity](const auto& pool) { return pool->Contains(entity); }) && !(pools.front()->GetPosition(entity) < group->Size))
+	{
+		for (auto& pool : pools)
+			pool->Swap(pool->GetPosition(entity), group->Size);
+		++group->Size;
+	}
+}
+
+void ecs::EntityManager::_LeaveGroup(internal::GroupData<EntityID>* group, const EntityID& entity)
+{
+	const auto& pools = group->Pools;
+	if (std::all_of(pools.cbegin(), pools.cend(), [&entity](const auto& pool) { return pool->Contains(entity); }) && pools.front()->GetPosition(entity) < group->Size)
+	{
+		--group->Size;
+		for (auto& pool : pools)
+			pool->Swap(pool->GetPosition(entity), group->Size);
+	}
+}
+
+void ecs::EntityManager::_RebuildGroup(Storage<EntityID>* pool)
+{
+	const auto group = pool->m_Group;
+	if (group == nullptr)
+		return;
+	const auto& pools = group->Pools;
+	const auto smallest = *std::min_element(pools.cbegin(), pools.cend(), [](const auto& left, const auto& right) { return left->GetSize() < right->GetSize(); });
+	/* Members are swapped to the front, entities at [Size, position) were already rejected */
+	group->Size = 0u;
+	for (std::size_t position = 0; position < smallest->GetSize(); ++position)
+		_EnterGroup(group, smallest->GetData()[position]);
 }
 
 const ecs::EntityManager::EntityData* ecs::EntityManager::_EntitiesBegin() const noexcept
@@ -1,10 +1,19 @@
 #pragma once
-#include "View.h"
+#include <tuple>
+#include "ColumnStorage.h"
 #include "System.h"
+#include "ThreadPool.h"
+#include "Hierarchy.h"
 
 namespace ecs
 {
 	class Entity;
+
+	template<typename Entity, typename... Component>
+	class BasicView;
+
+	template<typename Entity, typename... Component>
+	class BasicGroup;
 	/* Entity manager, collect all entities */
 	class EntityManager
 	{
@@ -13,6 +22,15 @@ namespace ecs
 		template<typename Entity, typename... Component>
 		friend class BasicView;
 
+		template<typename Entity, typename... Component>
+		friend class BasicGroup;
+
+		friend class Scheduler;
+
+		friend class CommandBuffer;
+
+		friend class Snapshot;
+
 		/* Entity manager iterator to iterate through all valid entities */
 		template<typename Entity>
 		class EntityManagerIterator
@@ -28,20 +46,20 @@ namespace ecs
 				m_First(first), m_Last(last), m_Current(first), m_Manager(manager)
 			{
 				/* Make sure that we are iterating only through valid entity*/
-				if (m_Current != m_Last && !m_Manager->IsValidEntity(std::get<0>(*m_Current)))
+				if (m_Current != m_Last && !m_Manager->IsValidEntity(*m_Current))
 					++(*this);
 			}
 		public:
-			EntityManagerIterator& operator++(int) noexcept { while (++m_Current != m_Last && !m_Manager->IsValidEntity(std::get<0>(*m_Current))); return (*this); }
-			EntityManagerIterator& operator--(int) noexcept { while (--m_Current != m_Last && !m_Manager->IsValidEntity(std::get<0>(*m_Current))); return (*this); }
-			EntityManagerIterator& operator++() noexcept { while (++m_Current != m_Last && !m_Manager->IsValidEntity(std::get<0>(*m_Current))); return (*this); }
-			EntityManagerIterator& operator--() noexcept { while (--m_Current != m_Last && !m_Manager->IsValidEntity(std::get<0>(*m_Current))); return (*this); }
+			EntityManagerIterator& operator++(int) noexcept { while (++m_Current != m_Last && !m_Manager->IsValidEntity(*m_Current)); return (*this); }
+			EntityManagerIterator& operator--(int) noexcept { while (--m_Current != m_Last && !m_Manager->IsValidEntity(*m_Current)); return (*this); }
+			EntityManagerIterator& operator++() noexcept { while (++m_Current != m_Last && !m_Manager->IsValidEntity(*m_Current)); return (*this); }
+			EntityManagerIterator& operator--() noexcept { while (--m_Current != m_Last && !m_Manager->IsValidEntity(*m_Current)); return (*this); }
 			bool operator==(const EntityManagerIterator& other) const noexcept { return other.m_Current == m_Current; }
 			bool operator!=(const EntityManagerIterator& other) const noexcept { return other.m_Current != m_Current; }
-			EntityID& operator*() { return std::get<0>(*m_Current);; }
-			EntityID* operator->() { return &std::get<0>(*m_Current); }
+			reference operator*() { return *m_Current; }
+			pointer operator->() { return m_Current; }
 			const reference operator*() const { return *m_Current; }
-			const pointer operator->() const { return m_Current; }
+			pointer operator->() const { return m_Current; }
 			operator bool() const { if (m_Current) return true; else return false; }
 		private:
 			pointer const m_First;
@@ -54,13 +72,23 @@ namespace ecs
 	public:
 		using Pools = std::vector<std::unique_ptr<Storage<EntityID>>>;
 		using Systems = std::unordered_map<TypeID, std::unique_ptr<BasicSystem>>;
-		using EntityData = std::tuple<EntityID, EntityID, std::vector<EntityID>>;
+		/* Entity table keeps only handle, hierarchy links are kept in m_Hierarchy */
+		using EntityData = EntityID;
+		using Groups = std::vector<std::unique_ptr<internal::GroupData<EntityID>>>;
+		/* Count of component bits in one signature word */
+		static constexpr std::size_t SignatureBits = 64u;
+		/* Local index of component pool, pools of each manager are dense */
+		using PoolIndex = std::uint32_t;
+		static constexpr PoolIndex NoPool = (std::numeric_limits<PoolIndex>::max)();
 	private:
 		using iterator = EntityManagerIterator<EntityData>;
 		using const_iterator = EntityManagerIterator<const EntityData>;
 	public:
 		EntityManager() = default;
 		EntityManager(void(*onCreateEntity)(Entity&));
+		/* All memory of entity table and component pools is taken from resource, resource has to outlive manager.
+		   With arena like std::pmr::monotonic_buffer_resource whole world is released by releasing the arena */
+		explicit EntityManager(std::pmr::memory_resource* resource, void(*onCreateEntity)(Entity&) = nullptr);
 		virtual ~EntityManager();
 	public:
 		/* Begin of entities iterator */
@@ -74,126 +102,413 @@ namespace ecs
 	public:
 		/* Create an entity */
 		Entity CreateEntity();
-		/* Destory all entities */
+		/* Create count of entities and write their handles to output iterator,
+		   on entity create callback is called after all entities are created */
+		template<typename Iterator>
+		void CreateEntities(const std::size_t& count, Iterator output)
+		{
+			_CreateEntities(count);
+			output = std::copy(m_Created.cbegin(), m_Created.cend(), output);
+			m_Created.clear();
+		}
+		/* Add copy of value to each entity of range */
+		template<typename Component, typename Iterator>
+		void Insert(Iterator first, Iterator last, const Component& value = {})
+		{
+			_Insert<Component>(first, last, [&value]() -> const Component& { return value; });
+		}
+		/* Add components from range starting at from to each entity of range */
+		template<typename Component, typename Iterator, typename ComponentIterator, typename = std::enable_if_t<!std::is_convertible_v<ComponentIterator, Component>>>
+		void Insert(Iterator first, Iterator last, ComponentIterator from)
+		{
+			_Insert<Component>(first, last, [&from]() -> decltype(auto) { return *from++; });
+		}
+		/* Destory all entities, pools are cleared at once instead of removing components entity by entity.
+		   Teardown is linear in count of entity slots, pools and their sparse pages, version of each slot is bumped so old handles stay invalid */
 		void DestroyAllEntites();
+		/* Return memory resource of manager */
+		std::pmr::memory_resource* GetResource() const noexcept { return m_Resource; }
 		/* Set on entiti create callback function */
 		void SetOnEntityCreate(void(*function)(Entity&));
 		/* Return true if manager has give component pool */
 		template<typename Component>
-		const bool HasComponentPool() const { static const TypeID index = TypeInfo<Component>::ID(); return (m_Pools.size() > index); }
+		bool HasComponentPool() const { return _GetIndex<Component>() != NoPool; }
 		/* Return view class that allow us to iterate through all entites with given set of components */
 		template<typename... Component>
-		BasicView<EntityID, Component...>View() { return BasicView<EntityID, Component...>(_GetCandidate<EntityID, Component...>(), &m_Pools, this); }
-		template<typename Component>
-		void RegisterSystem(void(*onCreate)(Component&), void(*onUpdate)(Component&), void(*onDestroy)(Component&))
+		BasicView<EntityID, Component...>View() { return BasicView<EntityID, Component...>(_GetCandidate<EntityID, Component...>(), { _GetPool<internal::Unwrap<Component>>()... }, this); }
+		/* Return view of entites with given set of components and without any of excluded components */
+		template<typename... Component, typename... Excluded>
+		BasicView<EntityID, Component...>View(Exclude<Excluded...>)
+		{
+			using ViewType = BasicView<EntityID, Component...>;
+			static_assert(sizeof...(Excluded) <= ViewType::MaxExcluded, "Too many excluded components !");
+			typename ViewType::ExcludedPools excluded;
+			((_GetIndex<Excluded>() != NoPool ? void(excluded.Indices[excluded.Size++] = _GetIndex<Excluded>()) : void()), ...);
+			return ViewType(_GetCandidate<EntityID, Component...>(), { _GetPool<internal::Unwrap<Component>>()... }, this, nullptr, excluded);
+		}
+		/* Execute for each entity with Local and World components in parent before child order, over cached order of hierarchy.
+		   Function takes (Entity&, const Local&, World&, const World* parent), parent is nullptr if entity has no parent
+		   or parent has no such components. Entities outside of hierarchy are visited first. Defined in Entity.h */
+		template<typename Local, typename World, typename Function>
+		void HierarchyEach(Function function);
+		/* Return owning group, entities with all given components are kept packed at the front of each owned pool.
+		   A component pool can be owned only by one group */
+		template<typename... Component>
+		BasicGroup<EntityID, Component...> Group()
 		{
-			static const TypeID index = TypeInfo<Component>::ID();
-			m_Systems[index] = std::make_unique<System<Component>>(onCreate, onUpdate, onDestroy);
+			const auto pools = std::make_tuple(_AssurePool<Component>()...);
+			auto group = std::get<0>(pools)->m_Group;
+			if (group == nullptr)
+			{
+				assert(((std::get<ComponentStorage<Component, EntityID>*>(pools)->m_Group == nullptr) && ...) && "Component pool is already owned by another group !");
+				group = m_Groups.emplace_back(std::make_unique<internal::GroupData<EntityID>>()).get();
+				group->Pools = { std::get<ComponentStorage<Component, EntityID>*>(pools)... };
+				for (auto pool : group->Pools)
+					pool->m_Group = group;
+				/* Move entities which already have all owned components to the front */
+				_RebuildGroup(std::get<0>(pools));
+			}
+			assert(group->Pools.size() == sizeof...(Component) && ((std::get<ComponentStorage<Component, EntityID>*>(pools)->m_Group == group) && ...) && "Group doesn't match owned components !");
+			return BasicGroup<EntityID, Component...>(group, pools, this);
+		}
+		/* Sort pool of component, compare takes two components. Entities and components are moved together,
+		   nearly sorted pool is sorted in linear time. Pool owned by group can't be sorted */
+		template<typename Component, typename Compare>
+		void Sort(Compare compare)
+		{
+			assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+			if (auto pool = _GetPool<Component>())
+			{
+				assert(pool->m_Group == nullptr && "Pool owned by group can't be sorted !");
+				pool->Sort(std::move(compare));
+			}
 		}
+		/* Sort pool of component like Sort, but compare takes two entity ids without version */
+		template<typename Component, typename Compare>
+		void SortByEntity(Compare compare)
+		{
+			assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+			if (auto pool = _GetPool<Component>())
+			{
+				assert(pool->m_Group == nullptr && "Pool owned by group can't be sorted !");
+				pool->SortByEntity(std::move(compare));
+			}
+		}
+		/* Sort pool of Component in order of pool of Other, entities with both components are moved to the front of pool in the same order
+		   as in pool of Other, so joined iteration is sequential in both pools. Pool owned by group can't be sorted */
+		template<typename Component, typename Other>
+		void SortAs()
+		{
+			assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+			auto pool = _GetPool<Component>();
+			const auto other = _GetPool<Other>();
+			if (pool && other)
+			{
+				assert(pool->m_Group == nullptr && "Pool owned by group can't be sorted !");
+				pool->SortAs(*other);
+			}
+		}
+		/* Register system of component, replaces previous one. Each hook is called with Component& and can be lambda,
+		   functor with state or function pointer, nullptr skips the hook. Update hook is inlined into the loop of update pass.
+		   Hooks which are all function pointers or nullptr make System<Component> */
+		template<typename Component, typename Create, typename Update, typename Destroy>
+		void RegisterSystem(Create onCreate, Update onUpdate, Destroy onDestroy)
+		{
+			static_assert(!internal::IsColumnar<Component>, "Component stored in columns can't have system !");
+			const TypeID index = TypeInfo<Component>::ID();
+			auto& system = m_Systems[index];
+			if constexpr (internal::IsHookPointer<Create, Component> && internal::IsHookPointer<Update, Component> && internal::IsHookPointer<Destroy, Component>)
+				system = std::make_unique<System<Component>>(onCreate, onUpdate, onDestroy);
+			else
+				system = std::make_unique<CallableSystem<Component, Create, Update, Destroy>>(std::move(onCreate), std::move(onUpdate), std::move(onDestroy));
+			if (auto pool = _GetPool<Component>())
+				pool->m_System = system.get();
+		}
+		/* Run update system for each component */
 		template<typename Component>
 		void OnUpdateSystem()
 		{
-			static const TypeID index = TypeInfo<Component>::ID();
-			if (HasComponentPool<Component>() && m_Systems.find(index) != m_Systems.end())
+			auto storage = _GetPool<Component>();
+			if (storage && storage->m_System)
+				static_cast<ComponentSystem<Component>*>(storage->m_System)->Update(*storage, 0u, storage->GetSize());
+		}
+		/* Run update system for each component on thread pool, components are split into chunks of policy grain.
+		   OnUpdate is called concurrently, no entities or components can be created or removed during the pass */
+		template<typename Component>
+		void ParallelUpdateSystem(const ParallelPolicy& policy = {})
+		{
+			auto storage = _GetPool<Component>();
+			if (storage && storage->m_System)
 			{
-				auto& components = static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get())->m_Components;
-				for (auto& component : components)
-					static_cast<System<Component>*>(m_Systems[index].get())->OnUpdate(*static_cast<Component*>(component.get()));
+				auto system = static_cast<ComponentSystem<Component>*>(storage->m_System);
+				const internal::ParallelPass pass(m_ParallelDepth);
+				GetThreadPool().ParallelFor(storage->GetSize(), policy, [storage, system](const std::size_t& begin, const std::size_t& end)
+					{
+						system->Update(*storage, begin, end);
+					});
 			}
 		}
+		/* Return thread pool used by parallel passes, it is created on first use */
+		ThreadPool& GetThreadPool();
+		/* Recreate thread pool with given count of worker threads */
+		void SetThreadsCount(const std::size_t& count);
 		/* Return count of valid entities */
 		std::size_t EntitiesCount() const;
+		/* Start next tick, added, changed and removed lists of all tracked pools are cleared */
+		void AdvanceTick();
+		/* Return entities which got component during current tick, component must be tracked (see ComponentTraits::TrackChanges) */
+		template<typename Component>
+		const std::pmr::vector<EntityID>& GetAdded() const { return _GetChanges<Component>(&internal::ChangeTracking<EntityID>::Added); }
+		/* Return entities which component was added or changed during current tick */
+		template<typename Component>
+		const std::pmr::vector<EntityID>& GetChanged() const { return _GetChanges<Component>(&internal::ChangeTracking<EntityID>::Changed); }
+		/* Return entities which lost component during current tick */
+		template<typename Component>
+		const std::pmr::vector<EntityID>& GetRemoved() const { return _GetChanges<Component>(&internal::ChangeTracking<EntityID>::Removed); }
+		/* Return memory used by each component pool */
+		std::vector<std::pair<TypeID, MemoryUsage>> GetMemoryReport() const;
 	private:
-		/* Add component to entity */
+		/* Add component to entity, return reference to component or tuple of references to fields of component stored in columns */
 		template<typename Component, typename... Args>
-		Component& AddComponent(const EntityID& entity, Args&&... args)
+		decltype(auto) AddComponent(const EntityID& entity, Args&&... args)
 		{
-			static const TypeID index = TypeInfo<Component>::ID();
+			assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
 			const auto handle = EntityTraits<EntityID>::ToID(entity);
-			if (!HasComponentPool<Component>())
-				m_Pools.resize(index + 1u);
-			if (m_Pools[index] == nullptr)
-				m_Pools[index] = std::make_unique<ComponentStorage<Component, EntityID>>();
-
-			auto& component = static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get())->Add(handle, std::forward<Args>(args)...);
-			if (m_Systems.find(index) != m_Systems.end())
-				static_cast<System<Component>*>(m_Systems[index].get())->OnCreate(component);
+			auto pool = _AssurePool<Component>();
 
+			decltype(auto) component = pool->Add(handle, std::forward<Args>(args)...);
+			_SetBit(handle, pool->GetIndex());
+			if constexpr (!internal::IsColumnar<Component>)
+			{
+				if (pool->m_System)
+					static_cast<ComponentSystem<Component>*>(pool->m_System)->Create(component);
+			}
+			/* Entering the group moves component, so it has to be taken again */
+			if (pool->m_Group)
+			{
+				_EnterGroup(pool->m_Group, handle);
+				return pool->Get(handle);
+			}
 			return component;
 		}
 		/* Get component from entity */
 		template<typename Component>
-		Component& GetComponent(const EntityID& entity)
+		decltype(auto) GetComponent(const EntityID& entity)
 		{
 			assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
-			const auto handle = EntityTraits<EntityID>::ToID(entity);
-			static const TypeID index = TypeInfo<Component>::ID();
-
-			return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get())->Get(handle);
+			return _GetPool<Component>()->Get(EntityTraits<EntityID>::ToID(entity));
+		}
+		/* Mark component of entity as changed during current tick, does nothing if component isn't tracked */
+		template<typename Component>
+		void MarkChanged(const EntityID& entity)
+		{
+			assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
+			if constexpr (internal::IsTracked<Component>::value)
+				_GetPool<Component>()->MarkChanged(EntityTraits<EntityID>::ToID(entity));
 		}
 		/* Remove component from entity */
 		template<typename Component>
 		void RemoveComponent(const EntityID& entity)
 		{
 			assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
+			assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
 			const auto handle = EntityTraits<EntityID>::ToID(entity);
-			static const TypeID index = TypeInfo<Component>::ID();
+			auto pool = _GetPool<Component>();
 
-			auto& component = GetComponent<Component>(entity);
-			if (m_Systems.find(index) != m_Systems.end())
-				static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get())->Remove(handle, m_Systems[index].get());
-			else
-				static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get())->Remove(handle);
-			
+			if (auto group = pool->m_Group)
+				_LeaveGroup(group, handle);
+			pool->Remove(handle, pool->m_System);
+			_ResetBit(handle, pool->GetIndex());
 		}
 		/* Return true if entiti has give component */
 		template<typename Component>
 		bool HasComponent(const EntityID& entity) const
 		{
-			const auto handle = EntityTraits<EntityID>::ToID(entity);
-			static const TypeID index = TypeInfo<Component>::ID();
-			return (HasComponentPool<Component>() && static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get())->Contains(handle));
+			return _HasComponent(EntityTraits<EntityID>::ToID(entity), _GetIndex<Component>());
+		}
+		/* Return true if entity is valid, handle of destroyed or recycled entity has old version in table. Id of null is never in table */
+		bool IsValidEntity(const EntityID& entity) const
+		{
+			const auto position = EntityTraits<EntityID>::ToID(entity);
+			return position < m_Entities.size() && m_Entities[position] == entity;
+		}
+		/* Return component of entity or nullptr if handle is stale or entity doesn't have the component.
+		   Version is checked in entity table and position is taken by one sparse lookup, so it is safe for any handle */
+		template<typename Component>
+		Component* TryGet(const EntityID& entity)
+		{
+			static_assert(!internal::IsColumnar<Component>, "Component stored in columns has no address !");
+			const auto position = EntityTraits<EntityID>::ToID(entity);
+			const auto pool = _GetPool<Component>();
+			if (pool == nullptr || !(position < m_Entities.size()) || m_Entities[position] != entity)
+				return nullptr;
+			const auto index = pool->Find(position);
+			return (index != SparseSet<EntityID>::Tombstone) ? &pool->GetAt(index) : nullptr;
 		}
-		/* Return true if entity is valid */
-		bool IsValidEntity(const EntityID& entity) const;
 		/* Destory entity */
 		void DestroyEntity(const EntityID& entity);
 		/* Add child to entity */
 		void AddChild(const EntityID& entity, const EntityID& child);
 		/* Remove child from entity */
 		bool RemoveChild(const EntityID& entity, const EntityID& child);
+		/* Remove all children from entity and keep them alive */
+		void RemoveChildren(const EntityID& entity);
 		/* Return true if entity has children */
 		bool HasChildren(const EntityID& entity) const;
 		/* Return parent handle*/
 		EntityID GetParent(const EntityID& entity) const;
 		/* Return true if entity has parent */
-		bool HasParent(const EntityID& entity);
-		/* Set parent for entity */
+		bool HasParent(const EntityID& entity) const;
+		/* Set parent for entity, null parent unset current one */
 		void SetParent(const EntityID& entity, const EntityID& parent);
 	private:
 		const EntityData* _EntitiesBegin() const noexcept;
 		const EntityData* _EntitiesEnd() const noexcept;
 		EntityData* _EntitiesBegin() noexcept;
 		EntityData* _EntitiesEnd() noexcept;
-		/* Return lowest SparseSet or nullptr */
+		/* Return component pool, create it if doesn't exist */
+		template<typename Component>
+		ComponentStorage<Component, EntityID>* _AssurePool()
+		{
+			const TypeID id = TypeInfo<Component>::ID();
+			if (!(id < m_Indices.size()))
+				m_Indices.resize(id + 1u, NoPool);
+			if (m_Indices[id] == NoPool)
+			{
+				/* Pools are kept dense, local index is position of pool in m_Pools */
+				const auto index = m_Pools.size();
+				m_Indices[id] = static_cast<PoolIndex>(index);
+				auto& pool = m_Pools.emplace_back(std::make_unique<ComponentStorage<Component, EntityID>>(m_Resource));
+				pool->m_Index = index;
+				if (const auto system = m_Systems.find(id); system != m_Systems.end())
+					pool->m_System = system->second.get();
+				if (!(index < m_SignatureWords * SignatureBits))
+					_ResizeSignatures(index / SignatureBits + 1u);
+			}
+			return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[m_Indices[id]].get());
+		}
+		/* Return local index of component pool or NoPool */
+		template<typename Component>
+		std::size_t _GetIndex() const noexcept
+		{
+			const TypeID id = TypeInfo<Component>::ID();
+			return (id < m_Indices.size()) ? m_Indices[id] : NoPool;
+		}
+		/* Set and reset bit of component pool in signature of entity */
+		void _SetBit(const EntityID& handle, const std::size_t& index) noexcept { _Signature(handle)[index / SignatureBits] |= (std::uint64_t(1u) << (index % SignatureBits)); }
+		void _ResetBit(const EntityID& handle, const std::size_t& index) noexcept { _Signature(handle)[index / SignatureBits] &= ~(std::uint64_t(1u) << (index % SignatureBits)); }
+		/* Return current handle with version of entity id */
+		EntityID _GetHandle(const EntityID& id) const noexcept { return m_Entities[id]; }
+		/* Return signature of entity */
+		std::uint64_t* _Signature(const EntityID& handle) noexcept { return m_Signatures.data() + handle * m_SignatureWords; }
+		const std::uint64_t* _Signature(const EntityID& handle) const noexcept { return m_Signatures.data() + handle * m_SignatureWords; }
+		/* Return true if signature of entity has bit of component pool, index is local index of pool */
+		bool _HasComponent(const EntityID& handle, const std::size_t& index) const noexcept
+		{
+			return index / SignatureBits < m_SignatureWords && handle < m_Entities.size() && (_Signature(handle)[index / SignatureBits] >> (index % SignatureBits)) & 1u;
+		}
+		/* Change count of signature words per entity */
+		void _ResizeSignatures(const std::size_t& words);
+		/* Remove all components of entity, entity stays in table and hierarchy */
+		void _RemoveComponents(const EntityID& handle);
+		/* Add components to range of entities, pool and system are looked up once for whole range */
+		template<typename Component, typename Iterator, typename Generator>
+		void _Insert(Iterator first, Iterator last, Generator generator)
+		{
+			assert(m_ParallelDepth == 0u && "Structural changes aren't allowed during parallel pass !");
+			auto pool = _AssurePool<Component>();
+			const auto begin = pool->GetSize();
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>)
+				pool->Reserve(begin + static_cast<std::size_t>(std::distance(first, last)));
+
+			for (; first != last; ++first)
+			{
+				const auto handle = EntityTraits<EntityID>::ToID(static_cast<EntityID>(*first));
+				pool->Add(handle, generator());
+				_SetBit(handle, pool->GetIndex());
+			}
+
+			if constexpr (!internal::IsColumnar<Component>)
+			{
+				if (const auto system = static_cast<ComponentSystem<Component>*>(pool->m_System))
+				{
+					for (auto position = begin; position < pool->GetSize(); ++position)
+						system->Create(pool->GetAt(position));
+				}
+			}
+			if (pool->m_Group)
+			{
+				for (auto position = begin; position < pool->GetSize(); ++position)
+					_EnterGroup(pool->m_Group, pool->GetData()[position]);
+			}
+		}
+		/* Take handle from destroyed entities or append new one */
+		EntityID _CreateHandle();
+		/* Create count of entities into scratch buffer */
+		void _CreateEntities(const std::size_t& count);
+		/* Move entity into group if it has all owned components */
+		void _EnterGroup(internal::GroupData<EntityID>* group, const EntityID& entity);
+		/* Move entity out of group if it is part of it */
+		void _LeaveGroup(internal::GroupData<EntityID>* group, const EntityID& entity);
+		/* Find all members of group which owns pool again, e.g. after pool was replaced by snapshot. Nothing is done if pool isn't owned */
+		void _RebuildGroup(Storage<EntityID>* pool);
+		/* Return component pool or nullptr */
+		template<typename Component>
+		ComponentStorage<Component, EntityID>* _GetPool() const
+		{
+			const auto index = _GetIndex<Component>();
+			return (index != NoPool) ? static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get()) : nullptr;
+		}
+		/* Return list of changes of tracked pool, or empty list if pool doesn't exist */
+		template<typename Component>
+		const std::pmr::vector<EntityID>& _GetChanges(std::pmr::vector<EntityID> internal::ChangeTracking<EntityID>::* list) const
+		{
+			static_assert(internal::IsTracked<Component>::value, "Component isn't tracked !");
+			static const std::pmr::vector<EntityID> empty;
+			const auto pool = _GetPool<Component>();
+			return pool ? pool->GetChanges()->*list : empty;
+		}
+		/* Return lowest SparseSet of required components or nullptr if any of them doesn't exist, optional components aren't considered */
 		template<typename Entity, typename... Component>
 		const SparseSet<Entity>* _GetCandidate() const
 		{
-			if ((HasComponentPool<Component>() && ...))
-			{
-				return (std::min)({ static_cast<const SparseSet<Entity>*>(m_Pools[TypeInfo<Component>::ID()].get())... }, [](const auto& left, const auto& right)
+			const SparseSet<Entity>* candidate = nullptr;
+			bool missing = false;
+			([&]()
+				{
+					if constexpr (!internal::IsOptional<Component>::value)
 					{
-						return left->GetSize() < right->GetSize();
-					});
-			}
-			return static_cast<SparseSet<Entity>*>(nullptr);
+						const SparseSet<Entity>* pool = _GetPool<Component>();
+						if (pool == nullptr)
+							missing = true;
+						else if (candidate == nullptr || pool->GetSize() < candidate->GetSize())
+							candidate = pool;
+					}
+				}(), ...);
+			return missing ? nullptr : candidate;
 		}
 	private:
+		std::pmr::memory_resource* m_Resource = std::pmr::get_default_resource();
+		/* Component pools in order of creation */
 		Pools m_Pools;
+		/* Local index of pool for each global type id */
+		std::vector<PoolIndex> m_Indices;
+		Groups m_Groups;
+		/* Components signature of each entity, one bit per component pool, m_SignatureWords words per entity */
+		std::pmr::vector<std::uint64_t> m_Signatures{ m_Resource };
+		std::size_t m_SignatureWords = 1u;
 		Systems m_Systems;
+		Hierarchy<EntityID> m_Hierarchy{ m_Resource };
 		EntityID m_Destroyed = ecs::null;
-		std::vector<EntityData>	m_Entities;
+		/* Count of destroyed entities which can be recycled */
+		std::size_t m_DestroyedCount = 0u;
+		/* Scratch buffer of batch entity creation */
+		std::pmr::vector<EntityID> m_Created{ m_Resource };
+		std::pmr::vector<EntityData> m_Entities{ m_Resource };
 		void (*m_OnEntityCreate)(Entity&) = nullptr;
+		std::unique_ptr<ThreadPool> m_ThreadPool;
+		/* Count of running parallel passes, passes run by scheduler can nest their own */
+		std::atomic<std::uint32_t> m_ParallelDepth = 0u;
 	private:
 	};
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+#include "Entity.h"
+
+namespace ecs
+{
+	/* Owning group class, all entities of the group are kept at [0, Size) of each owned pool in the same order,
+	   so iteration is a linear walk over parallel arrays without membership tests */
+	template<typename Entity, typename... Component>
+	class BasicGroup
+	{
+	public:
+		using Pools = std::tuple<ComponentStorage<Component, Entity>*...>;
+		/* Maximum count of rows passed to function at once by chunked iteration */
+		static constexpr std::size_t ChunkSize = internal::ChunkSize;
+	public:
+		BasicGroup(const internal::GroupData<Entity>* data = nullptr, const Pools& pools = {}, EntityManager* manager = nullptr) :
+			m_Data(data), m_Pools(pools), m_Manager(manager)
+		{}
+		virtual ~BasicGroup() = default;
+	public:
+		/* Execute for each entity of the group */
+		template<typename Function>
+		void Each(Function function)
+		{
+			_Each(function, 0u, GetSize(), std::index_sequence_for<Component...>{});
+		}
+		/* Execute for each entity of the group on thread pool, group is split into chunks of policy grain.
+		   Function is called concurrently, no entities or components can be created or removed during the pass */
+		template<typename Function>
+		void ParallelEach(Function function, const ParallelPolicy& policy = {})
+		{
+			if (IsEmpty())
+				return;
+			const internal::ParallelPass pass(m_Manager->m_ParallelDepth);
+			m_Manager->GetThreadPool().ParallelFor(GetSize(), policy, [this, &function](const std::size_t& begin, const std::size_t& end)
+				{
+					_Each(function, begin, end, std::index_sequence_for<Component...>{});
+				});
+		}
+		/* Execute for chunks of at most ChunkSize entities of the group, function takes (Span<const Entity> entities, Chunk... components).
+		   Entities are ids without version as kept in pools. Chunk is Span of components, or tuple of Spans of columns for component stored in columns (see ColumnStorage.h) */
+		template<typename Function>
+		void EachChunk(Function function)
+		{
+			_EachChunk(function, 0u, GetSize(), std::index_sequence_for<Component...>{});
+		}
+		/* Execute for chunks of the group on thread pool, each task of policy grain is split into its own chunks.
+		   Function is called concurrently, no entities or components can be created or removed during the pass */
+		template<typename Function>
+		void ParallelEachChunk(Function function, const ParallelPolicy& policy = {})
+		{
+			if (IsEmpty())
+				return;
+			const internal::ParallelPass pass(m_Manager->m_ParallelDepth);
+			m_Manager->GetThreadPool().ParallelFor(GetSize(), policy, [this, &function](const std::size_t& begin, const std::size_t& end)
+				{
+					_EachChunk(function, begin, end, std::index_sequence_for<Component...>{});
+				});
+		}
+		/* Return count of entities in group */
+		std::size_t GetSize() const { return (m_Data) ? m_Data->Size : 0u; }
+		/* Return true if group is empty */
+		bool IsEmpty() const { return GetSize() == 0u; }
+		/* Get data pointer of group entities */
+		const Entity* GetData() const { return (m_Data) ? std::get<0>(m_Pools)->GetData() : nullptr; }
+	private:
+		const internal::GroupData<Entity>* m_Data;
+		const Pools m_Pools;
+		EntityManager* const m_Manager;
+	private:
+		template<typename Function, std::size_t... Index>
+		void _Each(Function& function, const std::size_t& begin, const std::size_t& end, std::index_sequence<Index...>)
+		{
+			const auto entities = GetData();
+			ecs::Entity entity(ecs::null, m_Manager);
+			for (auto position = begin; position < end; ++position)
+			{
+				entity.m_Handle = m_Manager->_GetHandle(entities[position]);
+				function(entity, std::get<Index>(m_Pools)->GetAt(position)...);
+			}
+		}
+		/* Owned pools share order of group, so chunks are plain ranges */
+		template<typename Function, std::size_t... Index>
+		void _EachChunk(Function& function, const std::size_t& begin, const std::size_t& end, std::index_sequence<Index...>)
+		{
+			const auto entities = GetData();
+			for (auto position = begin; position < end; position += ChunkSize)
+			{
+				const auto count = (std::min)(ChunkSize, end - position);
+				function(Span<const Entity>(entities + position, count), std::get<Index>(m_Pools)->GetChunk(position, count)...);
+			}
+		}
+	};
+}
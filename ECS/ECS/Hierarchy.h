@@ -0,0 +1,201 @@
+#pragma once
+#include "Common.h"
+
+namespace ecs
+{
+	/* Links of one entity in hierarchy */
+	template<typename T>
+	struct HierarchyNode
+	{
+		T Parent = ecs::null;
+		T FirstChild = ecs::null;
+		T LastChild = ecs::null;
+		T Next = ecs::null;
+		T Prev = ecs::null;
+	};
+	/* Entities of hierarchy in parent before child order, kept in contiguous arrays */
+	template<typename T>
+	struct HierarchyOrder
+	{
+		/* Tombstone parent position of root entity */
+		static constexpr std::size_t Root = (std::numeric_limits<std::size_t>::max)();
+		explicit HierarchyOrder(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : Entities(resource), Parents(resource), Positions(resource) {}
+		/* Entities in breadth-first order, roots first */
+		std::pmr::vector<T> Entities;
+		/* Position of parent in Entities, Root for roots */
+		std::pmr::vector<std::size_t> Parents;
+		/* Scratch buffer of update pass, one entry per entity */
+		std::pmr::vector<std::size_t> Positions;
+	};
+	/* Hierarchy class, keeps parent, children and siblings as links in flat array indexed by entity id.
+	   Children are kept in order they were added, link and unlink are O(1). All arrays are allocated from memory resource */
+	template<typename T>
+	class Hierarchy
+	{
+	public:
+		using Node = HierarchyNode<T>;
+		using Order = HierarchyOrder<T>;
+	public:
+		explicit Hierarchy(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : m_Nodes(resource), m_Queue(resource), m_Order(resource) {}
+		~Hierarchy() = default;
+	public:
+		/* Add child to the end of children of parent, child mustn't have parent */
+		void Link(const T& parent, const T& child)
+		{
+			assert(GetParent(child) == ecs::null && "Child has already parent !");
+			_Assure((std::max)(EntityTraits<T>::ToID(parent), EntityTraits<T>::ToID(child)));
+			auto& parentNode = _Node(parent);
+			auto& childNode = _Node(child);
+			childNode.Parent = parent;
+			childNode.Prev = parentNode.LastChild;
+			childNode.Next = ecs::null;
+			if (parentNode.LastChild != ecs::null)
+				_Node(parentNode.LastChild).Next = child;
+			else
+				parentNode.FirstChild = child;
+			parentNode.LastChild = child;
+			m_Dirty = true;
+		}
+		/* Remove child from children of its parent */
+		void Unlink(const T& child)
+		{
+			if (GetParent(child) == ecs::null)
+				return;
+			auto& childNode = _Node(child);
+			auto& parentNode = _Node(childNode.Parent);
+			if (childNode.Prev != ecs::null)
+				_Node(childNode.Prev).Next = childNode.Next;
+			else
+				parentNode.FirstChild = childNode.Next;
+			if (childNode.Next != ecs::null)
+				_Node(childNode.Next).Prev = childNode.Prev;
+			else
+				parentNode.LastChild = childNode.Prev;
+			childNode.Parent = childNode.Next = childNode.Prev = ecs::null;
+			m_Dirty = true;
+		}
+		/* Unlink all children of entity, children are kept alive */
+		void UnlinkChildren(const T& parent)
+		{
+			if (!HasChildren(parent))
+				return;
+			auto& parentNode = _Node(parent);
+			for (auto current = parentNode.FirstChild; current != ecs::null;)
+			{
+				auto& node = _Node(current);
+				current = node.Next;
+				node.Parent = node.Next = node.Prev = ecs::null;
+			}
+			parentNode.FirstChild = parentNode.LastChild = ecs::null;
+			m_Dirty = true;
+		}
+		/* Unlink entity from its parent and children */
+		void Remove(const T& value)
+		{
+			Unlink(value);
+			UnlinkChildren(value);
+		}
+		/* Return parent of entity or null */
+		T GetParent(const T& value) const noexcept { return _Contains(value) ? _Node(value).Parent : T(ecs::null); }
+		/* Return first child of entity or null */
+		T GetFirstChild(const T& value) const noexcept { return _Contains(value) ? _Node(value).FirstChild : T(ecs::null); }
+		/* Return next sibling of entity or null */
+		T GetNextSibling(const T& value) const noexcept { return _Contains(value) ? _Node(value).Next : T(ecs::null); }
+		/* Return previous sibling of entity or null */
+		T GetPrevSibling(const T& value) const noexcept { return _Contains(value) ? _Node(value).Prev : T(ecs::null); }
+		/* Return true if entity has children */
+		bool HasChildren(const T& value) const noexcept { return GetFirstChild(value) != ecs::null; }
+		/* Return true if entity has parent or children */
+		bool IsLinked(const T& value) const noexcept { return _Contains(value) && (_Node(value).Parent != ecs::null || _Node(value).FirstChild != ecs::null); }
+		/* Return all linked entities in parent before child order, order is cached and rebuilt only after hierarchy was changed */
+		Order& GetOrder()
+		{
+			if (m_Dirty)
+				_BuildOrder();
+			return m_Order;
+		}
+		/* Execute for root and each of its descendants in breadth-first order, parent is always visited before its children.
+		   Hierarchy can't be changed during traversal */
+		template<typename Function>
+		void EachBreadthFirst(const T& root, Function function)
+		{
+			/* Scratch buffer is taken for the traversal, so nested traversals don't share it */
+			std::pmr::vector<T> order(m_Queue.get_allocator());
+			order.swap(m_Queue);
+			order.clear();
+			order.push_back(root);
+			for (std::size_t position = 0; position < order.size(); ++position)
+			{
+				for (auto child = GetFirstChild(order[position]); child != ecs::null; child = _Node(child).Next)
+					order.push_back(child);
+			}
+			for (const auto& value : order)
+				function(value);
+			order.swap(m_Queue);
+		}
+		/* Return links indexed by entity id */
+		const std::pmr::vector<Node>& GetNodes() const noexcept { return m_Nodes; }
+		/* Replace all links, cached order is rebuilt on next use */
+		void Assign(std::pmr::vector<Node>&& nodes) { m_Nodes = std::move(nodes); m_Dirty = true; }
+		/* Resize links to given count of entity ids */
+		void Resize(const std::size_t& count) { m_Nodes.resize(count); m_Dirty = true; }
+		/* Replace links of entity id, links of other entities aren't updated */
+		void SetNode(const std::size_t& id, const Node& node)
+		{
+			_Assure(id);
+			m_Nodes[id] = node;
+			m_Dirty = true;
+		}
+		/* Release all links */
+		void Clear() noexcept { m_Nodes.clear(); m_Dirty = true; }
+		/* Memory used by hierarchy, in bytes */
+		std::size_t GetMemoryUsage() const noexcept
+		{
+			return m_Nodes.capacity() * sizeof(Node) + m_Queue.capacity() * sizeof(T) +
+				m_Order.Entities.capacity() * sizeof(T) + (m_Order.Parents.capacity() + m_Order.Positions.capacity()) * sizeof(std::size_t);
+		}
+	private:
+		/* Links are indexed by entity id */
+		std::pmr::vector<Node> m_Nodes;
+		/* Scratch buffer of breadth-first traversal */
+		std::pmr::vector<T> m_Queue;
+		/* Cached order of all linked entities */
+		Order m_Order;
+		/* True if links were changed after order was built */
+		bool m_Dirty = false;
+	private:
+		void _BuildOrder()
+		{
+			auto& entities = m_Order.Entities;
+			auto& parents = m_Order.Parents;
+			entities.clear();
+			parents.clear();
+			/* Roots are taken from parent link of their first child, it keeps version of handle */
+			for (const auto& node : m_Nodes)
+			{
+				if (node.Parent == ecs::null && node.FirstChild != ecs::null)
+				{
+					entities.push_back(_Node(node.FirstChild).Parent);
+					parents.push_back(Order::Root);
+				}
+			}
+			for (std::size_t position = 0; position < entities.size(); ++position)
+			{
+				for (auto child = _Node(entities[position]).FirstChild; child != ecs::null; child = _Node(child).Next)
+				{
+					entities.push_back(child);
+					parents.push_back(position);
+				}
+			}
+			m_Dirty = false;
+		}
+		bool _Contains(const T& value) const noexcept { return EntityTraits<T>::ToID(value) < m_Nodes.size(); }
+		Node& _Node(const T& value) noexcept { return m_Nodes[EntityTraits<T>::ToID(value)]; }
+		const Node& _Node(const T& value) const noexcept { return m_Nodes[EntityTraits<T>::ToID(value)]; }
+		void _Assure(const std::size_t& id)
+		{
+			if (!(id < m_Nodes.size()))
+				m_Nodes.resize(id + 1u);
+		}
+	};
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "Common.h"
+
+namespace ecs
+{
+	/* Growable array of trivially copyable elements allocated from memory resource. Besides its own allocation it can adopt memory owned by someone else,
+	   e.g. mapped snapshot, the memory is kept alive by source and it's replaced by own allocation on first growth.
+	   Memory resource is moved together with elements. Own allocations are aligned to Alignment, e.g. to cache line for vectorized loops */
+	template<typename T, std::size_t Alignment = alignof(T)>
+	class PackedArray
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Packed array elements must be trivially copyable !");
+		static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1u)) == 0u, "Alignment must be power of two and at least alignment of element !");
+	public:
+		using value_type = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+	public:
+		explicit PackedArray(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept : m_Resource(resource) {}
+		~PackedArray() { _Release(); }
+		PackedArray(const PackedArray&) = delete;
+		PackedArray& operator=(const PackedArray&) = delete;
+		PackedArray(PackedArray&& other) noexcept { _Take(other); }
+		PackedArray& operator=(PackedArray&& other) noexcept
+		{
+			if (this != &other)
+			{
+				_Release();
+				_Take(other);
+			}
+			return *this;
+		}
+	public:
+		/* Use count elements at data without copying, source keeps the memory alive */
+		void Adopt(T* data, const std::size_t& count, std::shared_ptr<void> source)
+		{
+			_Release();
+			m_Data = data;
+			m_Size = m_Capacity = count;
+			m_Source = std::move(source);
+		}
+		/* Return memory resource of own allocations */
+		std::pmr::memory_resource* GetResource() const noexcept { return m_Resource; }
+		/* Return true if elements live in adopted memory */
+		bool IsAdopted() const noexcept { return m_Source != nullptr; }
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if (m_Size == m_Capacity)
+			{	/* Arguments can reference element of array, so value is made before reallocation */
+				const T value(std::forward<Args>(args)...);
+				_Reallocate(m_Capacity ? m_Capacity * 2u : 1u);
+				return *::new (static_cast<void*>(m_Data + m_Size++)) T(value);
+			}
+			return *::new (static_cast<void*>(m_Data + m_Size++)) T(std::forward<Args>(args)...);
+		}
+		void push_back(const T& value) { emplace_back(value); }
+		void pop_back() noexcept { --m_Size; }
+		void reserve(const std::size_t& count)
+		{
+			if (count > m_Capacity)
+				_Reallocate(count);
+		}
+		/* Resize array, new elements are value initialized */
+		void resize(const std::size_t& count)
+		{
+			reserve(count);
+			for (auto position = m_Size; position < count; ++position)
+				::new (static_cast<void*>(m_Data + position)) T();
+			m_Size = count;
+		}
+		void clear() noexcept { m_Size = 0u; }
+		std::size_t size() const noexcept { return m_Size; }
+		std::size_t capacity() const noexcept { return m_Capacity; }
+		bool empty() const noexcept { return m_Size == 0u; }
+		T* data() noexcept { return m_Data; }
+		const T* data() const noexcept { return m_Data; }
+		T& operator[](const std::size_t& position) noexcept { return m_Data[position]; }
+		const T& operator[](const std::size_t& position) const noexcept { return m_Data[position]; }
+		T& back() noexcept { return m_Data[m_Size - 1u]; }
+		const T& back() const noexcept { return m_Data[m_Size - 1u]; }
+		iterator begin() noexcept { return m_Data; }
+		iterator end() noexcept { return m_Data + m_Size; }
+		const_iterator begin() const noexcept { return m_Data; }
+		const_iterator end() const noexcept { return m_Data + m_Size; }
+	private:
+		std::pmr::memory_resource* m_Resource = std::pmr::get_default_resource();
+		T* m_Data = nullptr;
+		std::size_t m_Size = 0u;
+		std::size_t m_Capacity = 0u;
+		/* Owner of adopted memory, nullptr if memory is own allocation */
+		std::shared_ptr<void> m_Source;
+	private:
+		void _Reallocate(const std::size_t& capacity)
+		{
+			T* data = static_cast<T*>(m_Resource->allocate(capacity * sizeof(T), Alignment));
+			if (m_Size)
+				std::memcpy(data, m_Data, m_Size * sizeof(T));
+			const auto size = m_Size;
+			_Release();
+			m_Data = data;
+			m_Size = size;
+			m_Capacity = capacity;
+		}
+		void _Release() noexcept
+		{
+			if (m_Source)
+				m_Source.reset();
+			else if (m_Data)
+				m_Resource->deallocate(m_Data, m_Capacity * sizeof(T), Alignment);
+			m_Data = nullptr;
+			m_Size = m_Capacity = 0u;
+		}
+		void _Take(PackedArray& other) noexcept
+		{
+			m_Resource = other.m_Resource;
+			m_Data = std::exchange(other.m_Data, nullptr);
+			m_Size = std::exchange(other.m_Size, 0u);
+			m_Capacity = std::exchange(other.m_Capacity, 0u);
+			m_Source = std::move(other.m_Source);
+		}
+	};
+}
@@ -0,0 +1,54 @@
+#include "Scheduler.h"
+
+bool ecs::SystemAccess::ConflictsWith(const SystemAccess& other) const
+{
+	const auto intersects = [](const std::vector<TypeID>& left, const std::vector<TypeID>& right)
+	{
+		return std::any_of(left.cbegin(), left.cend(), [&right](const TypeID& id) { return std::find(right.cbegin(), right.cend(), id) != right.cend(); });
+	};
+	return intersects(Writes, other.Writes) || intersects(Writes, other.Reads) || intersects(Reads, other.Writes);
+}
+
+void ecs::Scheduler::Update()
+{
+	for (const auto& stage : GetStages())
+	{
+		/* Structural changes are rejected in every stage, not only in stages which share it with other systems */
+		const internal::ParallelPass pass(m_Manager.m_ParallelDepth);
+		if (stage.size() == 1u)
+		{
+			m_Systems[stage.front()].Function(m_Manager);
+			continue;
+		}
+		m_Manager.GetThreadPool().ParallelFor(stage.size(), { 1u, false }, [this, &stage](const std::size_t& begin, const std::size_t& end)
+			{
+				for (auto position = begin; position < end; ++position)
+					m_Systems[stage[position]].Function(m_Manager);
+			});
+	}
+}
+
+const std::vector<std::vector<std::size_t>>& ecs::Scheduler::GetStages()
+{
+	if (m_IsDirty)
+		_BuildStages();
+	return m_Stages;
+}
+
+void ecs::Scheduler::_BuildStages()
+{
+	std::vector<std::size_t> stages(m_Systems.size(), 0u);
+	m_Stages.clear();
+	for (std::size_t current = 0; current < m_Systems.size(); ++current)
+	{
+		for (std::size_t previous = 0; previous < current; ++previous)
+		{
+			if (m_Systems[current].Access.ConflictsWith(m_Systems[previous].Access))
+				stages[current] = (std::max)(stages[current], stages[previous] + 1u);
+		}
+		if (!(stages[current] < m_Stages.size()))
+			m_Stages.resize(stages[current] + 1u);
+		m_Stages[stages[current]].push_back(current);
+	}
+	m_IsDirty = false;
+}
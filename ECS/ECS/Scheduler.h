@@ -0,0 +1,73 @@
+#pragma once
+#include "Entity.h"
+
+namespace ecs
+{
+	/* Components which system only reads */
+	template<typename... Component>
+	struct Read {};
+	/* Components which system reads and writes */
+	template<typename... Component>
+	struct Write {};
+	/* Components accessed by system */
+	struct SystemAccess
+	{
+		std::vector<TypeID> Reads;
+		std::vector<TypeID> Writes;
+		/* Return true if systems can't run at the same time */
+		bool ConflictsWith(const SystemAccess& other) const;
+	};
+	/* System scheduler, builds stages from declared component access, systems of one stage don't conflict
+	   and run concurrently on thread pool, stages run one after another in order of registration.
+	   Systems can't create or remove entities or components, they record structural changes to CommandBuffer */
+	class Scheduler
+	{
+	public:
+		using Task = std::function<void(EntityManager&)>;
+	private:
+		struct ScheduledSystem
+		{
+			SystemAccess Access;
+			Task Function;
+		};
+	public:
+		Scheduler(EntityManager& manager) : m_Manager(manager) {}
+		virtual ~Scheduler() = default;
+	public:
+		/* Add system which runs for each entity with all read and written components,
+		   function is called as function(Entity&, const ReadComponent&..., WriteComponent&...) */
+		template<typename... ReadComponent, typename... WriteComponent, typename Function>
+		void AddSystem(Read<ReadComponent...>, Write<WriteComponent...>, Function function)
+		{
+			static_assert(sizeof...(ReadComponent) + sizeof...(WriteComponent) > 0u, "System has to access at least one component");
+			AddTask(Read<ReadComponent...>{}, Write<WriteComponent...>{}, [function](EntityManager& manager) mutable
+				{
+					manager.View<ReadComponent..., WriteComponent...>().Each([&function](Entity& entity, ReadComponent&... reads, WriteComponent&... writes)
+						{
+							function(entity, static_cast<const ReadComponent&>(reads)..., writes...);
+						});
+				});
+		}
+		/* Add system with custom body, function is called as function(EntityManager&) and must access only declared components */
+		template<typename... ReadComponent, typename... WriteComponent, typename Function>
+		void AddTask(Read<ReadComponent...>, Write<WriteComponent...>, Function function)
+		{
+			m_Systems.push_back({ { { TypeInfo<ReadComponent>::ID()... }, { TypeInfo<WriteComponent>::ID()... } }, Task(std::move(function)) });
+			m_IsDirty = true;
+		}
+		/* Run all systems once */
+		void Update();
+		/* Return indices of systems for each stage */
+		const std::vector<std::vector<std::size_t>>& GetStages();
+		/* Return count of systems */
+		std::size_t GetSystemsCount() const { return m_Systems.size(); }
+	private:
+		EntityManager& m_Manager;
+		std::vector<ScheduledSystem> m_Systems;
+		std::vector<std::vector<std::size_t>> m_Stages;
+		bool m_IsDirty = false;
+	private:
+		/* Place each system to the stage after the last conflicting system registered before it */
+		void _BuildStages();
+	};
+}
@@ -0,0 +1,364 @@
+#include "Snapshot.h"
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Size of record prefix, hash and size of record */
+static constexpr std::uint64_t RecordPrefix = sizeof(ecs::TypeHash) + sizeof(std::uint64_t);
+
+struct ecs::Snapshot::Mapping
+{
+	/* Stream buffer reading mapped memory, position of stream is position in memory */
+	class Buffer : public std::streambuf
+	{
+	public:
+		Buffer(char* data, const std::size_t& size) { setg(data, data, data + size); }
+		char* GetCurrent() const { return gptr(); }
+		std::size_t GetRemaining() const { return static_cast<std::size_t>(egptr() - gptr()); }
+	};
+	/* Owner of mapped memory, pools which adopted arrays keep copy of it */
+	std::shared_ptr<void> Source;
+	Buffer Memory;
+};
+
+bool ecs::Snapshot::Save(const EntityManager& manager, std::ostream& stream)
+{
+	assert(manager.m_ParallelDepth == 0u && "Snapshot can't be taken during parallel pass !");
+	Header header;
+	header.Pools = static_cast<std::uint32_t>(std::count_if(manager.m_Pools.cbegin(), manager.m_Pools.cend(), [](const auto& pool)
+		{
+			return pool && pool->IsSerializable();
+		}));
+	internal::Write(stream, header);
+	std::uint64_t offset = sizeof(header);
+	/* Entity table is written with destroyed entries, they keep links of free list and versions */
+	internal::Write(stream, static_cast<std::uint64_t>(manager.m_Entities.size()));
+	internal::WritePadding(stream, offset += sizeof(std::uint64_t));
+	offset = internal::Align(offset);
+	internal::Write(stream, manager.m_Entities.data(), manager.m_Entities.size());
+	internal::Write(stream, manager.m_Destroyed);
+	internal::Write(stream, static_cast<std::uint64_t>(manager.m_DestroyedCount));
+	const auto& nodes = manager.m_Hierarchy.GetNodes();
+	internal::Write(stream, static_cast<std::uint64_t>(nodes.size()));
+	internal::WritePadding(stream, offset += manager.m_Entities.size() * sizeof(EntityID) + sizeof(EntityID) + 2u * sizeof(std::uint64_t));
+	offset = internal::Align(offset);
+	internal::Write(stream, nodes.data(), nodes.size());
+	offset += nodes.size() * sizeof(Hierarchy<EntityID>::Node);
+	for (const auto& pool : manager.m_Pools)
+	{
+		if (pool && pool->IsSerializable())
+		{	/* Record starts aligned, prefix is right before it */
+			internal::WritePadding(stream, offset + RecordPrefix);
+			internal::Write(stream, pool->GetHash());
+			offset = internal::Align(offset + RecordPrefix) + pool->Save(stream);
+		}
+	}
+	return stream.good();
+}
+
+/* Parsed snapshot in memory, arrays point into snapshot data and they can be unaligned */
+struct Contents
+{
+	ecs::Snapshot::Header Header;
+	std::uint64_t Entities = 0u;
+	const char* EntitiesData = nullptr;
+	ecs::EntityID Destroyed = ecs::null;
+	std::uint64_t DestroyedCount = 0u;
+	std::uint64_t Nodes = 0u;
+	const char* NodesData = nullptr;
+	/* Hash, record data and record size of each pool */
+	std::vector<std::tuple<ecs::TypeHash, const char*, std::uint64_t>> Pools;
+};
+
+/* Parse snapshot written by Save, return false if data isn't valid snapshot */
+static bool Parse(const std::string_view& data, Contents& contents)
+{
+	std::uint64_t offset = 0u;
+	const auto read = [&data, &offset](auto& value)
+		{
+			if (data.size() < offset + sizeof(value))
+				return false;
+			std::memcpy(&value, data.data() + offset, sizeof(value));
+			offset += sizeof(value);
+			return true;
+		};
+	/* Take array at aligned offset */
+	const auto array = [&data, &offset](const char*& array, const std::uint64_t& count, const std::size_t& size)
+		{
+			offset = ecs::internal::Align(offset);
+			if (count > (data.size() - (std::min)(offset, std::uint64_t(data.size()))) / size)
+				return false;
+			array = data.data() + offset;
+			offset += count * size;
+			return true;
+		};
+	const ecs::Snapshot::Header expected;
+	auto& header = contents.Header;
+	if (!read(header) || header.Magic != expected.Magic || header.Version != expected.Version || header.EntitySize != expected.EntitySize)
+		return false;
+	if (!read(contents.Entities) || !array(contents.EntitiesData, contents.Entities, sizeof(ecs::EntityID)) ||
+		!read(contents.Destroyed) || !read(contents.DestroyedCount) ||
+		!read(contents.Nodes) || !array(contents.NodesData, contents.Nodes, sizeof(ecs::Hierarchy<ecs::EntityID>::Node)))
+		return false;
+	for (std::uint32_t index = 0; index < header.Pools; ++index)
+	{
+		offset = ecs::internal::Align(offset + RecordPrefix) - RecordPrefix;
+		ecs::TypeHash hash = 0u;
+		std::uint64_t size = 0u;
+		const char* record = nullptr;
+		if (!read(hash) || !read(size) || !array(record, size, 1u))
+			return false;
+		contents.Pools.emplace_back(hash, record, size);
+	}
+	return true;
+}
+
+bool ecs::Snapshot::SaveDelta(const EntityManager& manager, const std::string_view& previous, std::ostream& stream)
+{
+	assert(manager.m_ParallelDepth == 0u && "Delta can't be taken during parallel pass !");
+	Contents contents;
+	if (!Parse(previous, contents) || manager.m_Entities.size() < contents.Entities || manager.m_Hierarchy.GetNodes().size() < contents.Nodes)
+		return false;
+	const auto previousEntity = [&contents](const std::size_t& id)
+		{
+			EntityID entity;
+			std::memcpy(&entity, contents.EntitiesData + id * sizeof(EntityID), sizeof(EntityID));
+			return entity;
+		};
+	/* Entities alive in previous snapshot which handle isn't in the table anymore */
+	std::vector<bool> replaced(static_cast<std::size_t>(contents.Entities), false);
+	std::vector<EntityID> destroyed;
+	std::vector<std::uint64_t> slots;
+	for (std::size_t id = 0; id < manager.m_Entities.size(); ++id)
+	{
+		const auto& entity = manager.m_Entities[id];
+		if (id < contents.Entities && previousEntity(id) == entity)
+			continue;
+		if (id < contents.Entities && EntityTraits<EntityID>::ToID(previousEntity(id)) == id)
+		{
+			replaced[id] = true;
+			destroyed.push_back(previousEntity(id));
+		}
+		slots.push_back(id);
+	}
+	const auto& nodes = manager.m_Hierarchy.GetNodes();
+	std::vector<std::uint64_t> links;
+	for (std::size_t id = 0; id < nodes.size(); ++id)
+	{
+		if (!(id < contents.Nodes) || std::memcmp(contents.NodesData + id * sizeof(nodes[id]), &nodes[id], sizeof(nodes[id])) != 0)
+			links.push_back(id);
+	}
+	/* Pools without changes aren't written, so records are buffered to count them */
+	Header header;
+	header.Magic = DeltaMagic;
+	std::ostringstream pools(std::ios::binary);
+	for (const auto& pool : manager.m_Pools)
+	{
+		if (!pool)
+			continue;
+		/* Receiver would silently miss components of pool which can't be written */
+		assert((pool->IsSerializable() || pool->GetSize() == 0u) && "Delta can't be taken with components which can't be serialized !");
+		if (!pool->IsSerializable() && pool->GetSize() != 0u)
+			return false;
+		const auto found = std::find_if(contents.Pools.cbegin(), contents.Pools.cend(), [&pool](const auto& record) { return std::get<0>(record) == pool->GetHash(); });
+		std::ostringstream record(std::ios::binary);
+		if (found != contents.Pools.cend() ? pool->SaveDelta(record, std::get<1>(*found), std::get<2>(*found), replaced) : pool->SaveDelta(record, nullptr, 0u, replaced))
+		{
+			internal::Write(pools, pool->GetHash());
+			pools << record.str();
+			++header.Pools;
+		}
+	}
+
+	internal::Write(stream, header);
+	internal::Write(stream, static_cast<std::uint64_t>(manager.m_Entities.size()));
+	internal::Write(stream, manager.m_Destroyed);
+	internal::Write(stream, static_cast<std::uint64_t>(manager.m_DestroyedCount));
+	internal::Write(stream, static_cast<std::uint64_t>(destroyed.size()));
+	internal::Write(stream, destroyed.data(), destroyed.size());
+	internal::Write(stream, static_cast<std::uint64_t>(slots.size()));
+	internal::Write(stream, slots.data(), slots.size());
+	for (const auto& id : slots)
+		internal::Write(stream, manager.m_Entities[static_cast<std::size_t>(id)]);
+	internal::Write(stream, static_cast<std::uint64_t>(nodes.size()));
+	internal::Write(stream, static_cast<std::uint64_t>(links.size()));
+	internal::Write(stream, links.data(), links.size());
+	for (const auto& id : links)
+		internal::Write(stream, nodes[static_cast<std::size_t>(id)]);
+	stream << pools.str();
+	return stream.good();
+}
+
+bool ecs::Snapshot::_Map(EntityManager& manager, const std::string& path, bool(*load)(EntityManager&, std::istream&, Mapping*))
+{
+	std::shared_ptr<void> source;
+	std::size_t size = 0u;
+#if defined(_WIN32)
+	const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER length;
+	const HANDLE mapping = GetFileSizeEx(file, &length) && length.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return false;
+	void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == nullptr)
+		return false;
+	size = static_cast<std::size_t>(length.QuadPart);
+	source = std::shared_ptr<void>(data, [](void* data) { UnmapViewOfFile(data); });
+#else
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat status;
+	void* data = (fstat(file, &status) == 0 && status.st_size > 0) ? mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0) : MAP_FAILED;
+	close(file);
+	if (data == MAP_FAILED)
+		return false;
+	size = static_cast<std::size_t>(status.st_size);
+	source = std::shared_ptr<void>(data, [size](void* data) { munmap(data, size); });
+#endif
+	Mapping mapping{ std::move(source), Mapping::Buffer(static_cast<char*>(data), size) };
+	std::istream stream(&mapping.Memory);
+	return load(manager, stream, &mapping);
+}
+
+bool ecs::Snapshot::_LoadEntities(EntityManager& manager, std::istream& stream, Header& header, std::uint64_t& offset)
+{
+	assert(manager.m_Entities.empty() && "Snapshot can be loaded only into manager without entities !");
+	if (!manager.m_Entities.empty())
+		return false;
+	const Header expected;
+	if (!internal::Read(stream, header) || header.Magic != expected.Magic || header.Version != expected.Version || header.EntitySize != expected.EntitySize)
+		return false;
+	offset = sizeof(header);
+
+	std::uint64_t count = 0u;
+	if (!internal::Read(stream, count) || !internal::SkipPadding(stream, offset += sizeof(count)))
+		return false;
+	offset = internal::Align(offset);
+	std::pmr::vector<EntityManager::EntityData> entities(static_cast<std::size_t>(count), manager.m_Resource);
+	EntityID destroyed = ecs::null;
+	std::uint64_t destroyedCount = 0u;
+	if (!internal::Read(stream, entities.data(), entities.size()) || !internal::Read(stream, destroyed) || !internal::Read(stream, destroyedCount) || destroyedCount > count)
+		return false;
+	offset += entities.size() * sizeof(EntityID) + sizeof(destroyed) + sizeof(destroyedCount);
+
+	if (!internal::Read(stream, count) || !internal::SkipPadding(stream, offset += sizeof(count)))
+		return false;
+	offset = internal::Align(offset);
+	std::pmr::vector<Hierarchy<EntityID>::Node> nodes(static_cast<std::size_t>(count), manager.m_Resource);
+	if (!internal::Read(stream, nodes.data(), nodes.size()))
+		return false;
+	offset += nodes.size() * sizeof(Hierarchy<EntityID>::Node);
+
+	manager.m_Signatures.assign(entities.size() * manager.m_SignatureWords, 0u);
+	manager.m_Entities = std::move(entities);
+	manager.m_Destroyed = destroyed;
+	manager.m_DestroyedCount = static_cast<std::size_t>(destroyedCount);
+	manager.m_Hierarchy.Assign(std::move(nodes));
+	return true;
+}
+
+bool ecs::Snapshot::_BeginRecord(std::istream& stream, std::uint64_t& offset, TypeHash& hash, std::uint64_t& size)
+{
+	if (!internal::SkipPadding(stream, offset + RecordPrefix) || !internal::Read(stream, hash) || !internal::Read(stream, size))
+		return false;
+	offset = internal::Align(offset + RecordPrefix);
+	return true;
+}
+
+bool ecs::Snapshot::_ApplyEntities(EntityManager& manager, std::istream& stream, Header& header)
+{
+	assert(manager.m_ParallelDepth == 0u && "Delta can't be applied during parallel pass !");
+	const Header expected;
+	if (!internal::Read(stream, header) || header.Magic != DeltaMagic || header.Version != expected.Version || header.EntitySize != expected.EntitySize)
+		return false;
+	std::uint64_t size = 0u;
+	EntityID head = ecs::null;
+	std::uint64_t destroyedCount = 0u;
+	if (!internal::Read(stream, size) || !internal::Read(stream, head) || !internal::Read(stream, destroyedCount) || size < manager.m_Entities.size() || destroyedCount > size)
+		return false;
+
+	/* Destroyed entities lose their components, their slots are overwritten below */
+	std::uint64_t count = 0u;
+	std::vector<EntityID> destroyed;
+	if (!internal::Read(stream, count))
+		return false;
+	destroyed.resize(static_cast<std::size_t>(count));
+	if (!internal::Read(stream, destroyed.data(), destroyed.size()))
+		return false;
+	for (const auto& entity : destroyed)
+	{
+		if (manager.IsValidEntity(entity))
+			manager._RemoveComponents(EntityTraits<EntityID>::ToID(entity));
+	}
+
+	std::vector<std::uint64_t> ids;
+	if (!internal::Read(stream, count))
+		return false;
+	ids.resize(static_cast<std::size_t>(count));
+	std::vector<EntityID> entities(ids.size());
+	if (!internal::Read(stream, ids.data(), ids.size()) || !internal::Read(stream, entities.data(), entities.size()) ||
+		!std::all_of(ids.cbegin(), ids.cend(), [&size](const auto& id) { return id < size; }))
+		return false;
+	manager.m_Entities.resize(static_cast<std::size_t>(size));
+	manager.m_Signatures.resize(manager.m_Entities.size() * manager.m_SignatureWords, 0u);
+	for (std::size_t index = 0; index < ids.size(); ++index)
+		manager.m_Entities[static_cast<std::size_t>(ids[index])] = entities[index];
+	manager.m_Destroyed = head;
+	manager.m_DestroyedCount = static_cast<std::size_t>(destroyedCount);
+
+	if (!internal::Read(stream, size) || !internal::Read(stream, count))
+		return false;
+	ids.resize(static_cast<std::size_t>(count));
+	std::vector<Hierarchy<EntityID>::Node> nodes(ids.size());
+	if (!internal::Read(stream, ids.data(), ids.size()) || !internal::Read(stream, nodes.data(), nodes.size()) ||
+		!std::all_of(ids.cbegin(), ids.cend(), [&size](const auto& id) { return id < size; }))
+		return false;
+	manager.m_Hierarchy.Resize(static_cast<std::size_t>(size));
+	for (std::size_t index = 0; index < ids.size(); ++index)
+		manager.m_Hierarchy.SetNode(static_cast<std::size_t>(ids[index]), nodes[index]);
+	return true;
+}
+
+bool ecs::Snapshot::_LoadPool(EntityManager& manager, Storage<EntityID>* pool, std::istream& stream, const std::uint64_t& size, Mapping* mapping)
+{
+	if (mapping && size <= mapping->Memory.GetRemaining() && pool->Adopt(mapping->Memory.GetCurrent(), size, mapping->Source))
+	{
+		if (!_Skip(stream, size))
+			return false;
+	}
+	else if (!pool->Load(stream))
+		return false;
+	const auto index = pool->GetIndex();
+	for (std::size_t position = 0; position < pool->GetSize(); ++position)
+	{
+		const auto& entity = pool->GetData()[position];
+		if (!(entity < manager.m_Entities.size()))
+			return false;
+		manager._SetBit(entity, index);
+	}
+	/* Order of loaded pool doesn't keep members of its group at the front */
+	manager._RebuildGroup(pool);
+	return true;
+}
+
+bool ecs::Snapshot::_Skip(std::istream& stream, const std::uint64_t& size)
+{
+	const auto count = static_cast<std::streamsize>(size);
+	return stream.ignore(count).gcount() == count;
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "EntityManager.h"
+
+namespace ecs
+{
+	/* Binary snapshot of entity manager. It keeps entity table with free list, hierarchy and all serializable pools keyed by TypeInfo::Hash.
+	   Trivially copyable components are written as raw arrays, other components need SaveComponent and LoadComponent functions.
+	   Arrays are aligned to internal::SnapshotAlignment from start of snapshot, so mapped snapshot can be used in place.
+	   Delta between previous snapshot and current state of manager can be applied to other manager, e.g. for replication.
+	   Snapshots are native endian and they are valid only between builds with the same component layouts */
+	class Snapshot
+	{
+	public:
+		/* Snapshot header */
+		struct Header
+		{
+			std::uint32_t Magic = 0x53534345u; // "ECSS"
+			/* Version of layout, snapshots of other versions aren't loaded */
+			std::uint32_t Version = 2u;
+			/* Size of entity handle, snapshots with different handle size can't be loaded */
+			std::uint32_t EntitySize = static_cast<std::uint32_t>(sizeof(EntityID));
+			/* Count of pool records */
+			std::uint32_t Pools = 0u;
+		};
+		/* Magic of delta, delta uses the same header */
+		static constexpr std::uint32_t DeltaMagic = 0x44534345u; // "ECSD"
+	public:
+		/* Write snapshot of manager, pools of components which can't be serialized are skipped */
+		static bool Save(const EntityManager& manager, std::ostream& stream);
+		/* Load snapshot into manager without entities, handles and versions are restored exactly.
+		   Pools of listed components are rebuilt, other pools in snapshot are skipped.
+		   Systems and on create callback aren't called, if load fails manager should be discarded */
+		template<typename... Component>
+		static bool Load(EntityManager& manager, std::istream& stream) { return _Load<Component...>(manager, stream, nullptr); }
+		/* Load snapshot file like Load, but the file is mapped copy on write and pools of raw packed components use its arrays in place.
+		   Only sparse arrays are built, pools copy their arrays on first growth and the file stays mapped while any pool uses it */
+		template<typename... Component>
+		static bool Map(EntityManager& manager, const std::string& path)
+		{
+			return _Map(manager, path, [](EntityManager& manager, std::istream& stream, Mapping* mapping) { return _Load<Component...>(manager, stream, mapping); });
+		}
+		/* Write difference between previous snapshot written by Save and current state of manager.
+		   Delta keeps destroyed handles, changed entity slots and hierarchy links, and removed, added and modified components.
+		   Nothing is written and false is returned if manager has components which can't be serialized, e.g. components stored in columns */
+		static bool SaveDelta(const EntityManager& manager, const std::string_view& previous, std::ostream& stream);
+		/* Patch manager which matches previous snapshot of delta, so it matches the current one. Pools of listed components are patched, other pools are skipped.
+		   Components are added and removed through manager, so systems, groups and change tracking see the changes */
+		template<typename... Component>
+		static bool ApplyDelta(EntityManager& manager, std::istream& stream)
+		{
+			Header header;
+			if (!_ApplyEntities(manager, stream, header))
+				return false;
+			for (std::uint32_t index = 0; index < header.Pools; ++index)
+			{
+				TypeHash hash = 0u;
+				std::uint64_t size = 0u;
+				if (!internal::Read(stream, hash) || !internal::Read(stream, size))
+					return false;
+				bool known = false;
+				bool applied = false;
+				((!known && TypeInfo<Component>::Hash() == hash && (known = true, applied = _ApplyPool<Component>(manager, stream))), ...);
+				if (!known)
+					applied = _Skip(stream, size);
+				if (!applied)
+					return false;
+			}
+			return true;
+		}
+	private:
+		/* Mapped snapshot file */
+		struct Mapping;
+	private:
+		template<typename... Component>
+		static bool _Load(EntityManager& manager, std::istream& stream, Mapping* mapping)
+		{
+			Header header;
+			std::uint64_t offset = 0u;
+			if (!_LoadEntities(manager, stream, header, offset))
+				return false;
+			for (std::uint32_t index = 0; index < header.Pools; ++index)
+			{
+				TypeHash hash = 0u;
+				std::uint64_t size = 0u;
+				if (!_BeginRecord(stream, offset, hash, size))
+					return false;
+				bool known = false;
+				bool loaded = false;
+				((!known && TypeInfo<Component>::Hash() == hash && (known = true, loaded = _LoadPool(manager, manager._AssurePool<Component>(), stream, size, mapping))), ...);
+				if (!known)
+					loaded = _Skip(stream, size);
+				if (!loaded)
+					return false;
+				offset += size;
+			}
+			return true;
+		}
+		static bool _Map(EntityManager& manager, const std::string& path, bool(*load)(EntityManager&, std::istream&, Mapping*));
+		/* Read header, entity table and hierarchy, offset is moved behind them */
+		static bool _LoadEntities(EntityManager& manager, std::istream& stream, Header& header, std::uint64_t& offset);
+		/* Read padding and prefix of pool record, offset is moved to start of record */
+		static bool _BeginRecord(std::istream& stream, std::uint64_t& offset, TypeHash& hash, std::uint64_t& size);
+		/* Load or adopt pool record and set signature bits of its entities */
+		static bool _LoadPool(EntityManager& manager, Storage<EntityID>* pool, std::istream& stream, const std::uint64_t& size, Mapping* mapping);
+		/* Read destroyed handles, entity slots and hierarchy links of delta and apply them */
+		static bool _ApplyEntities(EntityManager& manager, std::istream& stream, Header& header);
+		/* Apply removed, added and modified components of delta record */
+		template<typename Component>
+		static bool _ApplyPool(EntityManager& manager, std::istream& stream)
+		{
+			if constexpr (internal::IsRaw<Component> || internal::HasSerializer<Component>::value)
+			{
+				std::uint64_t count = 0u;
+				std::vector<EntityID> entities;
+				const auto readEntities = [&]()
+					{
+						if (!internal::Read(stream, count))
+							return false;
+						entities.resize(static_cast<std::size_t>(count));
+						return internal::Read(stream, entities.data(), entities.size()) &&
+							std::all_of(entities.cbegin(), entities.cend(), [&manager](const auto& entity) { return entity < manager.m_Entities.size(); });
+					};
+				if (!readEntities())
+					return false;
+				for (const auto& entity : entities)
+				{
+					if (manager.HasComponent<Component>(entity))
+						manager.RemoveComponent<Component>(entity);
+				}
+				/* Added components are followed by modified ones, both are set the same way */
+				for (std::size_t list = 0; list < 2u; ++list)
+				{
+					if (!readEntities())
+						return false;
+					for (const auto& entity : entities)
+					{
+						Component component{};
+						if constexpr (internal::IsRaw<Component>)
+						{
+							if (!internal::Read(stream, component))
+								return false;
+						}
+						else if (LoadComponent(stream, component); !stream)
+							return false;
+						if (manager.HasComponent<Component>(entity))
+						{
+							manager.GetComponent<Component>(entity) = std::move(component);
+							manager.MarkChanged<Component>(entity);
+						}
+						else
+							manager.AddComponent<Component>(entity, std::move(component));
+					}
+				}
+				return true;
+			}
+			else
+				return false;
+		}
+		static bool _Skip(std::istream& stream, const std::uint64_t& size);
+	};
+}
@@ -1,22 +1,34 @@
 #pragma once
-#include "Common.h"
+#include "PackedArray.h"
 
 namespace ecs
 {
+	/* Memory used by container, in bytes */
+	struct MemoryUsage
+	{
+		/* Sparse array pages and page table */
+		std::size_t Sparse = 0u;
+		/* Tightly packed array */
+		std::size_t Packed = 0u;
+		/* Components linked with tightly packed array */
+		std::size_t Components = 0u;
+		/* Count of allocated sparse pages */
+		std::size_t Pages = 0u;
+	};
 	/* Sparse set class, allow us to get tightly packed array */
 	template<typename T>
 	class SparseSet
 	{
 	public:
 		/* SparseSet iterator to iterate through tightly packed array */
-		template<typename T>
+		template<typename Type>
 		class SparseSetIterator final
 		{
 			friend class SparseSet<T>;
 		public:
 			using iterator_category = std::random_access_iterator_tag;
 			using difference_type = std::ptrdiff_t;
-			using value_type = T;
+			using value_type = Type;
 			using pointer = value_type*;
 			using reference = value_type&;
 		public:
@@ -33,7 +45,7 @@ namespace ecs
 			reference operator*() { return *m_Current; }
 			pointer operator->() { return m_Current; }
 			const reference operator*() const { return *m_Current; }
-			const pointer operator->() const { return m_Current; }
+			pointer operator->() const { return m_Current; }
 			operator bool() const { if (m_Current) return true; else return false; }
 		private:
 			pointer const m_First;
@@ -45,59 +57,222 @@ namespace ecs
 	public:
 		using iterator = SparseSetIterator<T>;
 		using const_iterator = SparseSetIterator<const T>;
+		/* Count of sparse entries in one page, must be power of two */
+		static constexpr std::size_t PageSize = 4096u;
+		/* Value of sparse entry without element */
+		static constexpr T Tombstone = (std::numeric_limits<T>::max)();
 	public:
-		SparseSet() = default;
-		~SparseSet() = default;
+		explicit SparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			m_Resource(resource), m_Sparse(resource), m_Usage(resource), m_Packed(resource) {}
+		virtual ~SparseSet() { for (auto& page : m_Sparse) _FreePage(page); }
+		SparseSet(const SparseSet&) = delete;
+		SparseSet& operator=(const SparseSet&) = delete;
 	public:
 		/* Add element into array */
 		void Push(const T& value)
 		{
 			const auto position = m_Packed.size();
 			m_Packed.push_back(value);
-			if (!(value < m_Sparse.size()))
-				m_Sparse.resize(value + 1);
-			m_Sparse[value] = position;
+			_Assure(value / PageSize)[value & (PageSize - 1u)] = static_cast<T>(position);
+			++m_Usage[value / PageSize];
 		}
+		/* Fill empty array with given elements in one pass, elements must be unique */
+		void Assign(PackedArray<T>&& values)
+		{
+			assert(m_Packed.empty() && "Array isn't empty !");
+			m_Packed = std::move(values);
+			_BuildSparse();
+		}
+		/* Use elements at data as tightly packed array without copying, source keeps the memory alive */
+		void Adopt(T* data, const std::size_t& count, std::shared_ptr<void> source)
+		{
+			assert(m_Packed.empty() && "Array isn't empty !");
+			m_Packed.Adopt(data, count, std::move(source));
+			_BuildSparse();
+		}
+		/* Remove all elements and release their memory */
+		void Clear()
+		{
+			for (auto& page : m_Sparse)
+				_FreePage(page);
+			m_Sparse.clear();
+			m_Usage.clear();
+			m_Packed = PackedArray<T>(m_Resource);
+		}
+		/* Return memory resource of set */
+		std::pmr::memory_resource* GetResource() const noexcept { return m_Resource; }
+		/* Reserve tightly packed array for given count of elements */
+		void Reserve(const std::size_t& count) { m_Packed.reserve(count); }
 		/* Remove element from array */
 		void Pop(const T& value)
 		{
 			const auto last = m_Packed.back();
-			std::swap(m_Packed.back(), m_Packed[m_Sparse[value]]);
-			std::swap(m_Sparse[last], m_Sparse[value]);
+			const auto position = GetPosition(value);
+			m_Packed[position] = last;
+			_Entry(last) = static_cast<T>(position);
+			_Entry(value) = Tombstone;
 			m_Packed.pop_back();
+			/* Release page when last entry of it has been removed */
+			if (const auto page = value / PageSize; --m_Usage[page] == 0u)
+				_FreePage(m_Sparse[page]);
 		}
-		/* Sort array */
-		void Sort()
+		/* Swap two elements by positions in tightly packed array, storages override it so linked components are swapped too */
+		virtual void Swap(const std::size_t& left, const std::size_t& right)
 		{
-			std::sort(m_Packed.begin(), m_Packed.end());
-			for (auto position = 0; position < m_Packed.size(); position++) {
-				m_Sparse[m_Packed[position]] = position;
+			std::swap(m_Packed[left], m_Packed[right]);
+			_Entry(m_Packed[left]) = static_cast<T>(left);
+			_Entry(m_Packed[right]) = static_cast<T>(right);
+		}
+		/* Sort array by comparison of elements, elements are moved by Swap */
+		template<typename Compare = std::less<T>>
+		void Sort(Compare compare = Compare{})
+		{
+			_Sort([this, &compare](const std::size_t& left, const std::size_t& right) { return compare(m_Packed[left], m_Packed[right]); });
+		}
+		/* Move elements which are in other set to the front in the same order as in other set, other elements follow them */
+		void SortAs(const SparseSet& other)
+		{
+			std::size_t position = 0u;
+			for (std::size_t index = 0; index < other.GetSize() && position < GetSize(); ++index)
+			{
+				const auto& value = other.m_Packed[index];
+				if (!Contains(value))
+					continue;
+				/* Elements in front of position are already placed, so element is never behind it */
+				if (const auto current = GetPosition(value); current != position)
+					Swap(current, position);
+				++position;
 			}
 		}
 		/* Return true if array contains element */
-		bool Contains(const T& value) const { return (value < m_Sparse.size() && m_Sparse[value] < m_Packed.size() && m_Packed[m_Sparse[value]] == value); }
+		bool Contains(const T& value) const
+		{
+			/* Released pages point to shared page filled with tombstones, so no null check is needed */
+			const auto page = value / PageSize;
+			return (page < m_Sparse.size() && m_Sparse[page][value & (PageSize - 1u)] != Tombstone);
+		}
 		/* Get element position in tightly packed array */
-		std::size_t GetPosition(const T& value) const { return m_Sparse[value]; }
+		std::size_t GetPosition(const T& value) const { return m_Sparse[value / PageSize][value & (PageSize - 1u)]; }
+		/* Get element position in tightly packed array or Tombstone if array doesn't contain element */
+		std::size_t Find(const T& value) const
+		{
+			const auto page = value / PageSize;
+			return (page < m_Sparse.size()) ? m_Sparse[page][value & (PageSize - 1u)] : Tombstone;
+		}
 		/* Return size of tightly packed array */
 		std::size_t GetSize() const { return m_Packed.size(); }
 		/* Get data pointer of tightly packed array */
 		const T* GetData() const { return m_Packed.data(); }
 		/* Get const data pointer of tightly packed array */
 		T* GetData() { return m_Packed.data(); }
+		/* Return memory used by sparse and tightly packed arrays */
+		MemoryUsage GetMemoryUsage() const
+		{
+			MemoryUsage usage;
+			usage.Pages = std::count_if(m_Usage.cbegin(), m_Usage.cend(), [](const auto& count) { return count != 0u; });
+			usage.Sparse = usage.Pages * PageSize * sizeof(T) + m_Sparse.capacity() * sizeof(T*) + m_Usage.capacity() * sizeof(std::size_t);
+			usage.Packed = m_Packed.capacity() * sizeof(T);
+			return usage;
+		}
 	public:
 		/* Begin of tightly packed array iterator */
 		iterator begin() noexcept { return iterator(_Begin(), _End()); };
 		/* End of tightly packed array iterator */
 		iterator end() noexcept { return iterator(_End(), _End()); };
 		/* Const begin of tightly packed array iterator */
-		const_iterator cbegin() const noexcept { return begin(); };
+		const_iterator cbegin() const noexcept { return const_iterator(m_Packed.data(), m_Packed.data() + m_Packed.size()); };
 		/* Const begin of tightly packed array iterator */
-		const_iterator cend() const noexcept { return end(); };
+		const_iterator cend() const noexcept { return const_iterator(m_Packed.data() + m_Packed.size(), m_Packed.data() + m_Packed.size()); };
 	private:
-		std::vector<T> m_Sparse;
-		std::vector<T> m_Packed;
+		std::pmr::memory_resource* m_Resource;
+		/* Pages of sparse array, allocated on first touch */
+		std::pmr::vector<T*> m_Sparse;
+		/* Count of used entries in each page */
+		std::pmr::vector<std::size_t> m_Usage;
+		PackedArray<T> m_Packed;
+	protected:
+		/* Sort array by comparison of positions in tightly packed array, so linked components can be compared.
+		   Nearly sorted array is sorted in place by insertion, which gives up after one move per element and whole array is sorted then */
+		template<typename Less>
+		void _Sort(Less less)
+		{
+			const auto count = m_Packed.size();
+			auto budget = count;
+			bool sorted = true;
+			for (std::size_t position = 1; position < count && sorted; ++position)
+			{
+				for (auto current = position; current != 0u && less(current, current - 1u); --current)
+				{
+					if (budget-- == 0u)
+					{
+						sorted = false;
+						break;
+					}
+					Swap(current, current - 1u);
+				}
+			}
+			if (sorted)
+				return;
+			std::pmr::vector<std::size_t> order(count, m_Resource);
+			std::iota(order.begin(), order.end(), std::size_t(0u));
+			std::sort(order.begin(), order.end(), less);
+			/* Walk cycles of permutation, element of order[position] goes to position */
+			for (std::size_t position = 0; position < count; ++position)
+			{
+				auto current = position;
+				auto next = order[current];
+				while (next != position)
+				{
+					Swap(current, next);
+					order[current] = current;
+					current = next;
+					next = order[current];
+				}
+				order[current] = current;
+			}
+		}
 	private:
 		T* _Begin() noexcept { return m_Packed.data(); };
 		T* _End()   noexcept { return m_Packed.data() + m_Packed.size(); };
+		/* Get sparse entry of element */
+		T& _Entry(const T& value) noexcept { return m_Sparse[value / PageSize][value & (PageSize - 1u)]; }
+		/* Point sparse entries of all elements to their positions */
+		void _BuildSparse()
+		{
+			for (std::size_t position = 0; position < m_Packed.size(); ++position)
+			{
+				const auto& value = m_Packed[position];
+				_Assure(value / PageSize)[value & (PageSize - 1u)] = static_cast<T>(position);
+				++m_Usage[value / PageSize];
+			}
+		}
+		/* Make sure that page is allocated and return it */
+		T* _Assure(const std::size_t& page)
+		{
+			if (!(page < m_Sparse.size()))
+			{
+				m_Sparse.resize(page + 1u, _EmptyPage());
+				m_Usage.resize(page + 1u, 0u);
+			}
+			if (m_Sparse[page] == _EmptyPage())
+			{
+				m_Sparse[page] = static_cast<T*>(m_Resource->allocate(PageSize * sizeof(T), alignof(T)));
+				std::fill_n(m_Sparse[page], PageSize, Tombstone);
+			}
+			return m_Sparse[page];
+		}
+		/* Release page and point it to shared empty page */
+		void _FreePage(T*& page)
+		{
+			if (page != _EmptyPage())
+				m_Resource->deallocate(page, PageSize * sizeof(T), alignof(T));
+			page = _EmptyPage();
+		}
+		/* Shared read only page filled with tombstones */
+		static T* _EmptyPage()
+		{
+			static const std::array<T, PageSize> page = []() { std::array<T, PageSize> page; page.fill(Tombstone); return page; }();
+			return const_cast<T*>(page.data());
+		}
 	};
 }
@@ -1,29 +1,185 @@
 #pragma once
 #include "SparseSet.h"
+#include "BlockPool.h"
 #include "System.h"
 
 namespace ecs
 {
+	/* Component traits, specialize it to change the way component is stored. Specialization declares only members it changes, missing ones keep defaults below */
+	template<typename ComponentType, typename = void>
+	struct ComponentTraits
+	{
+		/* If true, each component lives in its own allocation and its address never changes,
+		   otherwise components are tightly packed by value in the same order as entities */
+		static constexpr bool StableReferences = false;
+		/* If true, pool keeps added, changed and removed entities of current tick, see EntityManager::AdvanceTick */
+		static constexpr bool TrackChanges = false;
+		/* Specialization can also list fields of aggregate component, static constexpr auto Fields = std::make_tuple(&Body::X, &Body::Y),
+		   then each field is kept in its own aligned array, see ColumnStorage.h */
+	};
+	template<typename Entity>
+	class Storage;
+
+	namespace internal
+	{
+		/* Owning group data, entities which have all owned components are kept in [0, Size) of each owned pool */
+		template<typename Entity>
+		struct GroupData
+		{
+			/* Owned pools */
+			std::vector<Storage<Entity>*> Pools;
+			/* Count of entities in group */
+			std::size_t Size = 0u;
+		};
+		/* Change state of one component of tracked pool */
+		struct ChangeSlot
+		{
+			/* Ticks when component was added and last changed */
+			Tick Added = 0u;
+			Tick Changed = 0u;
+			/* Positions of entity in lists of added and changed entities, valid only if the tick is current */
+			std::size_t AddedAt = 0u;
+			std::size_t ChangedAt = 0u;
+		};
+		/* Changes of tracked pool during current tick, all lists are allocated from memory resource of the pool */
+		template<typename Entity>
+		struct ChangeTracking
+		{
+			explicit ChangeTracking(std::pmr::memory_resource* resource) : Slots(resource), Added(resource), Changed(resource), Removed(resource) {}
+			/* Current tick, 0 is never current */
+			Tick Current = 1u;
+			/* Change state of each component, in the same order as tightly packed entities */
+			std::pmr::vector<ChangeSlot> Slots;
+			/* Entities which got component during current tick */
+			std::pmr::vector<Entity> Added;
+			/* Entities which component was added or changed during current tick, each entity is there once */
+			std::pmr::vector<Entity> Changed;
+			/* Entities which lost component during current tick */
+			std::pmr::vector<Entity> Removed;
+		};
+		/* True if component traits enable stable references, traits without StableReferences member keep components by value */
+		template<typename ComponentType, typename = void>
+		struct IsStable : std::false_type {};
+		template<typename ComponentType>
+		struct IsStable<ComponentType, std::void_t<decltype(ComponentTraits<ComponentType>::StableReferences)>> : std::bool_constant<ComponentTraits<ComponentType>::StableReferences> {};
+		/* True if component traits enable change tracking, traits without TrackChanges member aren't tracked */
+		template<typename ComponentType, typename = void>
+		struct IsTracked : std::false_type {};
+		template<typename ComponentType>
+		struct IsTracked<ComponentType, std::void_t<decltype(ComponentTraits<ComponentType>::TrackChanges)>> : std::bool_constant<ComponentTraits<ComponentType>::TrackChanges> {};
+		/* True if component provides SaveComponent(std::ostream&, const T&) and LoadComponent(std::istream&, T&) found by argument dependent lookup */
+		template<typename ComponentType, typename = void>
+		struct HasSerializer : std::false_type {};
+		template<typename ComponentType>
+		struct HasSerializer<ComponentType, std::void_t<
+			decltype(SaveComponent(std::declval<std::ostream&>(), std::declval<const ComponentType&>())),
+			decltype(LoadComponent(std::declval<std::istream&>(), std::declval<ComponentType&>()))>> : std::true_type {};
+		/* True if component is written to snapshot as raw bytes */
+		template<typename ComponentType>
+		inline constexpr bool IsRaw = std::is_trivially_copyable_v<ComponentType> && !HasSerializer<ComponentType>::value;
+		/* Write raw bytes of array, snapshots are native endian */
+		template<typename T>
+		void Write(std::ostream& stream, const T* data, const std::size_t& count)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written raw !");
+			stream.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+		}
+		template<typename T>
+		void Write(std::ostream& stream, const T& value) { Write(stream, &value, 1u); }
+		/* Read raw bytes of array, return false if stream ended earlier */
+		template<typename T>
+		bool Read(std::istream& stream, T* data, const std::size_t& count)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read raw !");
+			const auto size = static_cast<std::streamsize>(count * sizeof(T));
+			return stream.read(reinterpret_cast<char*>(data), size).gcount() == size;
+		}
+		template<typename T>
+		bool Read(std::istream& stream, T& value) { return Read(stream, &value, 1u); }
+		/* Alignment of arrays in snapshot, so arrays of mapped snapshot can be used in place */
+		inline constexpr std::uint64_t SnapshotAlignment = 64u;
+		constexpr std::uint64_t Align(const std::uint64_t& offset) noexcept { return (offset + SnapshotAlignment - 1u) & ~(SnapshotAlignment - 1u); }
+		/* Write zeros from offset to next aligned offset */
+		inline void WritePadding(std::ostream& stream, const std::uint64_t& offset)
+		{
+			static const char zeros[SnapshotAlignment] = {};
+			stream.write(zeros, static_cast<std::streamsize>(Align(offset) - offset));
+		}
+		/* Skip bytes from offset to next aligned offset */
+		inline bool SkipPadding(std::istream& stream, const std::uint64_t& offset)
+		{
+			const auto count = static_cast<std::streamsize>(Align(offset) - offset);
+			return stream.ignore(count).gcount() == count;
+		}
+	}
 	/* Base components storage class */
 	template<typename Entity>
 	class Storage : public SparseSet<Entity>
 	{
 		friend class EntityManager;
 	public:
-		Storage(const TypeID& id, const TypeHash& hash, void(*destroy)(const Entity&, Storage<Entity>*, BasicSystem*)) :
-			m_Id(id), m_Hash(hash), m_Destroy(destroy){}
+		Storage(const TypeID& id, const TypeHash& hash, void(*destroy)(const Entity&, Storage<Entity>*, BasicSystem*), std::pmr::memory_resource* resource) :
+			SparseSet<Entity>(resource), m_Id(id), m_Hash(hash), m_Destroy(destroy){}
 		virtual ~Storage() = default;
 	public:
 		TypeID GetID() const { return m_Id; }
-		TypeID GetHash() const { return m_Hash; }
+		TypeHash GetHash() const { return m_Hash; }
+		/* Return local index of storage in its manager */
+		std::size_t GetIndex() const { return m_Index; }
+		/* Return changes of current tick or nullptr if pool isn't tracked */
+		const internal::ChangeTracking<Entity>* GetChanges() const { return m_Changes ? &*m_Changes : nullptr; }
+		/* Start next tick, lists of changes are cleared */
+		void AdvanceTick()
+		{
+			if (!m_Changes)
+				return;
+			m_Changes->Added.clear();
+			m_Changes->Changed.clear();
+			m_Changes->Removed.clear();
+			/* On wrap around all components are marked as neither added nor changed */
+			if (++m_Changes->Current == 0u)
+			{
+				std::fill(m_Changes->Slots.begin(), m_Changes->Slots.end(), internal::ChangeSlot{});
+				m_Changes->Current = 1u;
+			}
+		}
+		/* Return memory used by storage */
+		virtual MemoryUsage GetMemoryUsage() const { return SparseSet<Entity>::GetMemoryUsage(); }
+		/* Remove all components at once and release their memory, system is notified about each destroyed component */
+		virtual void Clear(BasicSystem* system) { (void)system; SparseSet<Entity>::Clear(); }
+		/* Return true if components can be written to snapshot */
+		virtual bool IsSerializable() const { return false; }
+		/* Write size of record in bytes followed by tightly packed entities and components, return size of record */
+		virtual std::uint64_t Save(std::ostream& stream) const { (void)stream; return 0u; }
+		/* Fill empty storage with record written by Save, size prefix has to be already consumed */
+		virtual bool Load(std::istream& stream) { (void)stream; return false; }
+		/* Use arrays of record at data in place, source keeps the memory alive. Return false if record has to be loaded */
+		virtual bool Adopt(char* data, const std::uint64_t& size, const std::shared_ptr<void>& source) { (void)data; (void)size; (void)source; return false; }
+		/* Write size of delta record followed by removed, added and modified components against record of previous snapshot or nullptr.
+		   Replaced marks ids which entity was destroyed since previous snapshot. Return false if nothing was written */
+		virtual bool SaveDelta(std::ostream& stream, const char* previous, const std::uint64_t& size, const std::vector<bool>& replaced) const
+		{
+			(void)stream; (void)previous; (void)size; (void)replaced;
+			return false;
+		}
+		/* Swap two elements and linked components by positions in tightly packed array */
+		void Swap(const std::size_t& left, const std::size_t& right) override { SparseSet<Entity>::Swap(left, right); }
 	protected:
 		const TypeID m_Id;
 		const TypeHash m_Hash;
+		/* Local index of storage, set by manager */
+		std::size_t m_Index = 0u;
+		/* Group which owns the storage or nullptr */
+		internal::GroupData<Entity>* m_Group = nullptr;
 		/* Destroy callback for single entity */
 		void (*m_Destroy)(const Entity&, Storage<Entity>*, BasicSystem*)= nullptr;
+		/* System of component or nullptr, set by manager so hooks are found without lookup */
+		BasicSystem* m_System = nullptr;
+		/* Changes of current tick, only for tracked components */
+		std::optional<internal::ChangeTracking<Entity>> m_Changes;
 	};
-	/* Component storage class */
-	template<typename ComponentType, typename Entity>
+	/* Component storage class, last parameter selects specialization */
+	template<typename ComponentType, typename Entity, typename = void>
 	class ComponentStorage : public Storage<Entity>
 	{
 		friend class EntityManager;
@@ -34,30 +190,101 @@ namespace ecs
 		/* Getting acces to storage class */
 		using SetTraits = SparseSet<Entity>;
 		using StorageTraits = Storage<Entity>;
+		/* Stable references layout */
+		static constexpr bool IsStable = internal::IsStable<ComponentType>::value;
+		/* Stored element, component by value or pointer to component allocated from block pool */
+		using Element = std::conditional_t<IsStable, ComponentType*, ComponentType>;
+		/* Change tracking */
+		static constexpr bool IsTracked = internal::IsTracked<ComponentType>::value;
+		/* Trivially copyable components stored by value are kept in packed array, which can adopt mapped snapshot */
+		static constexpr bool IsPacked = std::is_trivially_copyable_v<ComponentType> && !IsStable;
+		using Components = std::conditional_t<IsPacked, PackedArray<ComponentType>, std::pmr::vector<Element>>;
+		/* Snapshot layout, trivially copyable components are written as raw array, others through their serializer */
+		static constexpr bool IsRaw = internal::IsRaw<ComponentType>;
+		static constexpr bool CanSerialize = IsRaw || internal::HasSerializer<ComponentType>::value;
+		/* Offset of tightly packed entities in record, they follow count of entities */
+		static constexpr std::uint64_t EntitiesOffset = internal::Align(sizeof(std::uint64_t));
 	public:
-		ComponentStorage() : Storage<Entity>(TypeInfo<ComponentType>::ID(), TypeInfo<ComponentType>::Hash(),
+		/* All memory of storage is taken from resource, stable components are allocated from block pool of the storage */
+		explicit ComponentStorage(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : Storage<Entity>(TypeInfo<ComponentType>::ID(), TypeInfo<ComponentType>::Hash(),
 			[](const Entity& entity, Storage<Entity>* storage, BasicSystem* system)
 			{	/* Capture type */
 				static_cast<ComponentStorage<ComponentType, Entity>*>(storage)->Remove(entity, system);
-			}){}
-		virtual ~ComponentStorage() = default; // TODO !
+			}, resource), m_Components(resource), m_Blocks(sizeof(ComponentType), alignof(ComponentType), resource)
+		{
+			if constexpr (IsTracked)
+				StorageTraits::m_Changes.emplace(resource);
+		}
+		virtual ~ComponentStorage() { _DestroyComponents(); }
 	public:
 		/* Link component with given id */
 		template<typename... Args>
 		ComponentType& Add(const Entity& entity, Args&&... args)
 		{
 			assert(!Contains(entity) && "Entity has the component !");
-			m_Components.emplace_back(std::make_unique<ComponentType>(std::forward<Args>(args)...));
+			if constexpr (IsStable)
+				m_Components.push_back(_Create(std::forward<Args>(args)...));
+			else if constexpr (std::is_aggregate_v<ComponentType> && !std::is_constructible_v<ComponentType, Args...>)
+				m_Components.push_back(ComponentType{ std::forward<Args>(args)... });
+			else
+				m_Components.emplace_back(std::forward<Args>(args)...);
 			SetTraits::Push(entity);
-			return *m_Components.back().get();
+			if constexpr (IsTracked)
+			{
+				auto& changes = *StorageTraits::m_Changes;
+				changes.Slots.push_back({ changes.Current, changes.Current, changes.Added.size(), changes.Changed.size() });
+				changes.Added.push_back(entity);
+				changes.Changed.push_back(entity);
+			}
+			return GetAt(m_Components.size() - 1u);
+		}
+		/* Mark component of entity as changed during current tick */
+		void MarkChanged(const Entity& entity)
+		{
+			assert(Contains(entity) && "Entity doesn't have the component !");
+			if constexpr (IsTracked)
+			{
+				auto& changes = *StorageTraits::m_Changes;
+				if (auto& slot = changes.Slots[SetTraits::GetPosition(entity)]; slot.Changed != changes.Current)
+				{
+					slot.Changed = changes.Current;
+					slot.ChangedAt = changes.Changed.size();
+					changes.Changed.push_back(entity);
+				}
+			}
+		}
+		/* Reserve storage for given count of components */
+		void Reserve(const std::size_t& count)
+		{
+			m_Components.reserve(count);
+			SetTraits::Reserve(count);
+			if constexpr (IsTracked)
+				StorageTraits::m_Changes->Slots.reserve(count);
 		}
 		/* Unlink component from given id */
 		void Remove(const Entity& entity, BasicSystem* system = nullptr)
 		{
 			assert(Contains(entity) && "Entity doesn't have the component !");
-			if (system) static_cast<System<ComponentType>*>(system)->OnDestroy(*m_Components[SetTraits::GetPosition(entity)].get());
-			auto other = std::move(m_Components.back());
-			m_Components[SetTraits::GetPosition(entity)] = std::move(other);
+			const auto position = SetTraits::GetPosition(entity);
+			if (system) static_cast<ComponentSystem<ComponentType>*>(system)->Destroy(GetAt(position));
+			if constexpr (IsTracked)
+			{
+				auto& changes = *StorageTraits::m_Changes;
+				/* Entity is in lists of added and changed entities only if its component was added or changed during current tick */
+				const auto slot = changes.Slots[position];
+				if (slot.Added == changes.Current)
+					_Unlist(changes.Added, slot.AddedAt, &internal::ChangeSlot::AddedAt);
+				if (slot.Changed == changes.Current)
+					_Unlist(changes.Changed, slot.ChangedAt, &internal::ChangeSlot::ChangedAt);
+				changes.Slots[position] = changes.Slots.back();
+				changes.Slots.pop_back();
+				changes.Removed.push_back(entity);
+			}
+			if constexpr (IsStable)
+				_Destroy(m_Components[position]);
+			/* Swap with last and pop, keep components in the same order as tightly packed entities */
+			if (position != m_Components.size() - 1u)
+				m_Components[position] = std::move(m_Components.back());
 			m_Components.pop_back();
 			SetTraits::Pop(entity);
 		}
@@ -65,11 +292,368 @@ namespace ecs
 		ComponentType& Get(const Entity& entity)
 		{
 			assert(Contains(entity) && "Entity doesn't have the component !");
-			return *m_Components[SetTraits::GetPosition(entity)].get();
+			return GetAt(SetTraits::GetPosition(entity));
+		}
+		/* Get component by position in tightly packed array */
+		ComponentType& GetAt(const std::size_t& position)
+		{
+			return const_cast<ComponentType&>(const_cast<const ComponentStorage*>(this)->GetAt(position));
+		}
+		/* Get const component by position in tightly packed array */
+		const ComponentType& GetAt(const std::size_t& position) const
+		{
+			if constexpr (IsStable)
+				return *m_Components[position];
+			else
+				return m_Components[position];
+		}
+		/* Return span of count components starting at position in tightly packed array */
+		Span<ComponentType> GetChunk(const std::size_t& position, const std::size_t& count)
+		{
+			static_assert(!IsStable, "Components with stable references aren't contiguous !");
+			assert(position + count <= SetTraits::GetSize() && "Rows are out of range !");
+			return { m_Components.data() + position, count };
+		}
+		Span<const ComponentType> GetChunk(const std::size_t& position, const std::size_t& count) const
+		{
+			static_assert(!IsStable, "Components with stable references aren't contiguous !");
+			assert(position + count <= SetTraits::GetSize() && "Rows are out of range !");
+			return { m_Components.data() + position, count };
 		}
 		/* Return true if id is in storage */
 		bool Contains(const Entity& entity) const { return SetTraits::Contains(entity); }
+		/* Sort entities and components together, compare takes two components */
+		template<typename Compare>
+		void Sort(Compare compare)
+		{
+			SetTraits::_Sort([this, &compare](const std::size_t& left, const std::size_t& right) { return compare(std::as_const(*this).GetAt(left), std::as_const(*this).GetAt(right)); });
+		}
+		/* Sort entities and components together, compare takes two entities */
+		template<typename Compare>
+		void SortByEntity(Compare compare)
+		{
+			SetTraits::Sort(std::move(compare));
+		}
+		/* Swap two components by positions in tightly packed array */
+		void Swap(const std::size_t& left, const std::size_t& right) override
+		{
+			std::swap(m_Components[left], m_Components[right]);
+			SetTraits::Swap(left, right);
+			if constexpr (IsTracked)
+				std::swap(StorageTraits::m_Changes->Slots[left], StorageTraits::m_Changes->Slots[right]);
+		}
+		/* Return memory used by storage */
+		MemoryUsage GetMemoryUsage() const override
+		{
+			auto usage = SetTraits::GetMemoryUsage();
+			usage.Components = m_Components.capacity() * sizeof(Element) + m_Blocks.GetCapacity();
+			if (const auto& changes = StorageTraits::m_Changes)
+				usage.Components += changes->Slots.capacity() * sizeof(internal::ChangeSlot) + (changes->Added.capacity() + changes->Changed.capacity() + changes->Removed.capacity()) * sizeof(Entity);
+			return usage;
+		}
+		/* Remove all components at once and release their memory, system is notified about each destroyed component.
+		   Trivially destructible components are released without touching them */
+		void Clear(BasicSystem* system) override
+		{
+			if (auto typed = static_cast<ComponentSystem<ComponentType>*>(system); typed && typed->HasDestroy())
+			{
+				for (std::size_t position = 0; position < m_Components.size(); ++position)
+					typed->Destroy(GetAt(position));
+			}
+			if constexpr (IsTracked)
+			{
+				auto& changes = *StorageTraits::m_Changes;
+				changes.Removed.insert(changes.Removed.end(), SetTraits::GetData(), SetTraits::GetData() + SetTraits::GetSize());
+				changes.Added.clear();
+				changes.Changed.clear();
+				changes.Slots.clear();
+			}
+			_DestroyComponents();
+			m_Blocks.Release();
+			m_Components = Components(SetTraits::GetResource());
+			SetTraits::Clear();
+		}
+		/* Return true if components can be written to snapshot */
+		bool IsSerializable() const override { return CanSerialize; }
+		/* Write size of record in bytes followed by tightly packed entities and components, return size of record.
+		   Record starts with count of entities, entities and raw components are aligned to SnapshotAlignment from record start */
+		std::uint64_t Save(std::ostream& stream) const override
+		{
+			if constexpr (CanSerialize)
+			{
+				if constexpr (IsRaw)
+				{
+					const auto count = static_cast<std::uint64_t>(SetTraits::GetSize());
+					const auto size = _ComponentsOffset(count) + count * sizeof(ComponentType);
+					internal::Write(stream, size);
+					_SaveRecord(stream);
+					return size;
+				}
+				else
+				{	/* Size of serialized components isn't known ahead, record is buffered */
+					std::ostringstream record(std::ios::binary);
+					_SaveRecord(record);
+					const auto data = record.str();
+					internal::Write(stream, static_cast<std::uint64_t>(data.size()));
+					stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+					return data.size();
+				}
+			}
+			else
+				return 0u;
+		}
+		/* Fill empty storage with record written by Save, size prefix has to be already consumed.
+		   Members of group which owns storage are moved to the front by manager afterwards */
+		bool Load(std::istream& stream) override
+		{
+			assert(SetTraits::GetSize() == 0u && "Storage isn't empty !");
+			if constexpr (CanSerialize)
+			{
+				std::uint64_t count = 0u;
+				if (!internal::Read(stream, count) || !internal::SkipPadding(stream, sizeof(count)))
+					return false;
+				PackedArray<Entity> entities(SetTraits::GetResource());
+				entities.resize(static_cast<std::size_t>(count));
+				if (!internal::Read(stream, entities.data(), entities.size()) || !internal::SkipPadding(stream, EntitiesOffset + count * sizeof(Entity)))
+					return false;
+				if constexpr (IsRaw && IsPacked)
+				{
+					m_Components.resize(entities.size());
+					if (!internal::Read(stream, m_Components.data(), m_Components.size()))
+						return _DestroyComponents(), false;
+				}
+				else
+				{
+					m_Components.reserve(entities.size());
+					for (std::size_t index = 0; index < entities.size(); ++index)
+					{
+						ComponentType component{};
+						if constexpr (IsRaw)
+						{
+							if (!internal::Read(stream, component))
+								return _DestroyComponents(), false;
+						}
+						else
+							LoadComponent(stream, component);
+						if constexpr (IsStable)
+							m_Components.push_back(_Create(std::move(component)));
+						else
+							m_Components.push_back(std::move(component));
+					}
+					if (!stream)
+						return _DestroyComponents(), false;
+				}
+				_ResetTicks(entities.size());
+				SetTraits::Assign(std::move(entities));
+				return true;
+			}
+			else
+				return false;
+		}
+		/* Use entities and raw components of record at data in place, they are copied on first growth of pool.
+		   Data is private copy on write memory, so members of group which owns storage are swapped to the front in place by manager */
+		bool Adopt(char* data, const std::uint64_t& size, const std::shared_ptr<void>& source) override
+		{
+			assert(SetTraits::GetSize() == 0u && "Storage isn't empty !");
+			if constexpr (IsRaw && IsPacked && alignof(ComponentType) <= internal::SnapshotAlignment)
+			{
+				std::uint64_t count = 0u;
+				if (size < sizeof(count) || reinterpret_cast<std::uintptr_t>(data) % internal::SnapshotAlignment != 0u)
+					return false;
+				std::memcpy(&count, data, sizeof(count));
+				if (_ComponentsOffset(count) + count * sizeof(ComponentType) > size)
+					return false;
+				m_Components.Adopt(reinterpret_cast<ComponentType*>(data + _ComponentsOffset(count)), static_cast<std::size_t>(count), source);
+				_ResetTicks(static_cast<std::size_t>(count));
+				SetTraits::Adopt(reinterpret_cast<Entity*>(data + EntitiesOffset), static_cast<std::size_t>(count), source);
+				return true;
+			}
+			else
+				return false;
+		}
+		/* Write size of delta record followed by removed, added and modified components against record of previous snapshot or nullptr.
+		   Raw components are compared bytewise, other components by bytes written by their serializer. Return false if nothing was written */
+		bool SaveDelta(std::ostream& stream, const char* previous, const std::uint64_t& size, const std::vector<bool>& replaced) const override
+		{
+			if constexpr (CanSerialize)
+			{
+				std::uint64_t count = 0u;
+				if (previous)
+				{
+					if (size < sizeof(count))
+						return false;
+					std::memcpy(&count, previous, sizeof(count));
+					if (_ComponentsOffset(count) + (IsRaw ? count * sizeof(ComponentType) : 0u) > size)
+						return false;
+				}
+				/* Serialized components don't have fixed size, bounds of previous components are found by loading them */
+				std::vector<std::uint64_t> bounds;
+				if constexpr (!IsRaw)
+				{
+					std::istringstream components(previous ? std::string(previous + _ComponentsOffset(count), static_cast<std::size_t>(size - _ComponentsOffset(count))) : std::string(), std::ios::binary);
+					bounds.push_back(0u);
+					for (std::size_t position = 0; position < count; ++position)
+					{
+						ComponentType component{};
+						LoadComponent(components, component);
+						if (!components)
+							return false;
+						bounds.push_back(static_cast<std::uint64_t>(components.tellg()));
+					}
+				}
+				const auto isReplaced = [&replaced](const Entity& entity) { return entity < replaced.size() && replaced[entity]; };
+				/* Positions of previous components by entity */
+				constexpr auto none = (std::numeric_limits<std::size_t>::max)();
+				std::vector<std::size_t> positions;
+				std::vector<Entity> removed;
+				for (std::size_t position = 0; position < count; ++position)
+				{
+					Entity entity;
+					std::memcpy(&entity, previous + EntitiesOffset + position * sizeof(Entity), sizeof(Entity));
+					if (!(entity < positions.size()))
+						positions.resize(entity + 1u, none);
+					positions[entity] = position;
+					/* Components of destroyed entities are removed with them */
+					if (!Contains(entity) && !isReplaced(entity))
+						removed.push_back(entity);
+				}
+				std::ostringstream bytes(std::ios::binary);
+				const auto isModified = [&](const std::size_t& previousPosition, const std::size_t& position)
+				{
+					const char* component = previous + _ComponentsOffset(count);
+					if constexpr (IsRaw)
+						return std::memcmp(component + previousPosition * sizeof(ComponentType), &GetAt(position), sizeof(ComponentType)) != 0;
+					else
+					{
+						bytes.str({});
+						SaveComponent(bytes, GetAt(position));
+						const auto current = bytes.str();
+						return current.size() != bounds[previousPosition + 1u] - bounds[previousPosition] || std::memcmp(component + bounds[previousPosition], current.data(), current.size()) != 0;
+					}
+				};
+				std::vector<std::size_t> added;
+				std::vector<std::size_t> modified;
+				for (std::size_t position = 0; position < SetTraits::GetSize(); ++position)
+				{
+					const auto& entity = SetTraits::GetData()[position];
+					if (!(entity < positions.size()) || positions[entity] == none || isReplaced(entity))
+						added.push_back(position);
+					else if (isModified(positions[entity], position))
+						modified.push_back(position);
+				}
+				if (removed.empty() && added.empty() && modified.empty())
+					return false;
+				const auto writeRecord = [&](std::ostream& record)
+				{
+					internal::Write(record, static_cast<std::uint64_t>(removed.size()));
+					internal::Write(record, removed.data(), removed.size());
+					for (const auto* list : { &added, &modified })
+					{
+						internal::Write(record, static_cast<std::uint64_t>(list->size()));
+						for (const auto& position : *list)
+							internal::Write(record, SetTraits::GetData()[position]);
+						for (const auto& position : *list)
+						{
+							if constexpr (IsRaw)
+								internal::Write(record, GetAt(position));
+							else
+								SaveComponent(record, GetAt(position));
+						}
+					}
+				};
+				if constexpr (IsRaw)
+				{
+					internal::Write(stream, static_cast<std::uint64_t>(sizeof(std::uint64_t) * 3u + removed.size() * sizeof(Entity) + (added.size() + modified.size()) * (sizeof(Entity) + sizeof(ComponentType))));
+					writeRecord(stream);
+				}
+				else
+				{	/* Size of serialized components isn't known ahead, record is buffered */
+					std::ostringstream record(std::ios::binary);
+					writeRecord(record);
+					const auto data = record.str();
+					internal::Write(stream, static_cast<std::uint64_t>(data.size()));
+					stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+				}
+				return true;
+			}
+			else
+				return false;
+		}
 	private:
-		std::vector<std::unique_ptr<ComponentType>> m_Components;
+		Components m_Components;
+		/* Blocks of stable components */
+		BlockPool m_Blocks;
+	private:
+		/* Construct stable component in block */
+		template<typename... Args>
+		ComponentType* _Create(Args&&... args)
+		{
+			void* block = m_Blocks.Allocate();
+			try
+			{
+				if constexpr (std::is_aggregate_v<ComponentType> && !std::is_constructible_v<ComponentType, Args...>)
+					return ::new (block) ComponentType{ std::forward<Args>(args)... };
+				else
+					return ::new (block) ComponentType(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				m_Blocks.Deallocate(block);
+				throw;
+			}
+		}
+		/* Destroy all components, blocks of stable components are kept until pool is released */
+		void _DestroyComponents()
+		{
+			if constexpr (IsStable && !std::is_trivially_destructible_v<ComponentType>)
+			{
+				for (auto& component : m_Components)
+					component->~ComponentType();
+			}
+			m_Components.clear();
+		}
+		/* Destroy stable component and return its block */
+		void _Destroy(ComponentType* component)
+		{
+			component->~ComponentType();
+			m_Blocks.Deallocate(component);
+		}
+		static constexpr std::uint64_t _ComponentsOffset(const std::uint64_t& count) noexcept { return internal::Align(EntitiesOffset + count * sizeof(Entity)); }
+		void _SaveRecord(std::ostream& stream) const
+		{
+			const auto count = SetTraits::GetSize();
+			internal::Write(stream, static_cast<std::uint64_t>(count));
+			internal::WritePadding(stream, sizeof(std::uint64_t));
+			internal::Write(stream, SetTraits::GetData(), count);
+			internal::WritePadding(stream, EntitiesOffset + count * sizeof(Entity));
+			if constexpr (IsRaw && IsPacked)
+				internal::Write(stream, m_Components.data(), count);
+			else
+			{
+				for (std::size_t position = 0; position < count; ++position)
+				{
+					if constexpr (IsRaw)
+						internal::Write(stream, GetAt(position));
+					else
+						SaveComponent(stream, GetAt(position));
+				}
+			}
+		}
+		/* Loaded components are neither added nor changed in current tick */
+		void _ResetTicks(const std::size_t& count)
+		{
+			if constexpr (IsTracked)
+				StorageTraits::m_Changes->Slots.assign(count, internal::ChangeSlot{});
+		}
+		/* Swap and pop entity at given position of list of changes, position of entity moved in its place is updated */
+		void _Unlist(std::pmr::vector<Entity>& list, const std::size_t& at, std::size_t internal::ChangeSlot::* slotAt)
+		{
+			if (at != list.size() - 1u)
+			{
+				list[at] = list.back();
+				StorageTraits::m_Changes->Slots[SetTraits::GetPosition(list[at])].*slotAt = at;
+			}
+			list.pop_back();
+		}
 	};
 }
\ No newline at end of file
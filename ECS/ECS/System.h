@@ -5,22 +5,118 @@ namespace ecs
 {
 	class Entity;
 
+	template<typename ComponentType, typename Entity, typename>
+	class ComponentStorage;
+
 	class BasicSystem
 	{
 	public:
 		BasicSystem() = default;
 		virtual ~BasicSystem() = default;
 	};
-
+	namespace internal
+	{
+		/* True if hook is function pointer taking component or nullptr */
+		template<typename Hook, typename Component>
+		inline constexpr bool IsHookPointer = std::is_same_v<Hook, void(*)(Component&)> || std::is_null_pointer_v<Hook>;
+	}
+	/* Interface of system of component, manager calls its hooks on create, update and destroy of component */
+	template<typename Component>
+	class ComponentSystem : public BasicSystem
+	{
+	public:
+		using Storage = ComponentStorage<Component, EntityID, void>;
+	public:
+		ComponentSystem() = default;
+		virtual ~ComponentSystem() = default;
+	public:
+		virtual void Create(Component& component) = 0;
+		virtual void Destroy(Component& component) = 0;
+		/* Update components [begin, end) of pool, it is one virtual call per range, so body of hook can be inlined into the loop */
+		virtual void Update(Storage& storage, const std::size_t& begin, const std::size_t& end) = 0;
+		/* Return true if system has destroy hook, pool can be cleared without touching components otherwise */
+		virtual bool HasDestroy() const = 0;
+	};
+	/* System made of function pointers, hook which is nullptr is skipped */
 	template<typename Component>
-	class System : public BasicSystem
+	class System : public ComponentSystem<Component>
 	{
+	public:
+		using Storage = typename ComponentSystem<Component>::Storage;
 	public:
 		System(void(*onCreate)(Component&), void(*onUpdate)(Component&), void(*onDestroy)(Component&)):
 			OnCreate(onCreate), OnUpdate(onUpdate), OnDestroy(onDestroy) {}
 		virtual ~System() = default;
+	public:
+		void Create(Component& component) override { if (OnCreate) OnCreate(component); }
+		void Destroy(Component& component) override { if (OnDestroy) OnDestroy(component); }
+		void Update(Storage& storage, const std::size_t& begin, const std::size_t& end) override
+		{
+			if (!OnUpdate)
+				return;
+			for (auto position = begin; position < end; ++position)
+				OnUpdate(storage.GetAt(position));
+		}
+		bool HasDestroy() const override { return OnDestroy != nullptr; }
+	public:
 		void(*OnCreate)(Component&) = nullptr;
 		void(*OnUpdate)(Component&) = nullptr;
 		void(*OnDestroy)(Component&) = nullptr;
 	};
-}
\ No newline at end of file
+	/* System made of callables, each hook is lambda, functor with state or function pointer. Hook given as nullptr is skipped */
+	template<typename Component, typename CreateHook, typename UpdateHook, typename DestroyHook>
+	class CallableSystem final : public ComponentSystem<Component>
+	{
+	public:
+		using Storage = typename ComponentSystem<Component>::Storage;
+	public:
+		CallableSystem(CreateHook onCreate, UpdateHook onUpdate, DestroyHook onDestroy) :
+			m_OnCreate(std::move(onCreate)), m_OnUpdate(std::move(onUpdate)), m_OnDestroy(std::move(onDestroy)) {}
+	public:
+		void Create(Component& component) override { _Call(m_OnCreate, component); }
+		void Destroy(Component& component) override { _Call(m_OnDestroy, component); }
+		void Update(Storage& storage, const std::size_t& begin, const std::size_t& end) override
+		{
+			if constexpr (!IsNone<UpdateHook>)
+			{
+				if (!_IsSet(m_OnUpdate))
+					return;
+				for (auto position = begin; position < end; ++position)
+					m_OnUpdate(storage.GetAt(position));
+			}
+		}
+		bool HasDestroy() const override
+		{
+			if constexpr (IsNone<DestroyHook>)
+				return false;
+			else
+				return _IsSet(m_OnDestroy);
+		}
+	private:
+		template<typename Function>
+		static constexpr bool IsNone = std::is_same_v<Function, std::nullptr_t>;
+	private:
+		CreateHook m_OnCreate;
+		UpdateHook m_OnUpdate;
+		DestroyHook m_OnDestroy;
+	private:
+		/* Function pointer can be null, other callables are always set */
+		template<typename Function>
+		static bool _IsSet(const Function& function)
+		{
+			if constexpr (std::is_pointer_v<Function>)
+				return function != nullptr;
+			else
+				return true;
+		}
+		template<typename Function>
+		static void _Call(Function& function, Component& component)
+		{
+			if constexpr (!IsNone<Function>)
+			{
+				if (_IsSet(function))
+					function(component);
+			}
+		}
+	};
+}
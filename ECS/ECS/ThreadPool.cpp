@@ -0,0 +1,139 @@
+#include "ThreadPool.h"
+
+namespace
+{
+	/* Pool and index of worker which is running on current thread */
+	thread_local const ecs::ThreadPool* s_Pool = nullptr;
+	thread_local std::size_t s_Index = 0u;
+}
+
+ecs::ThreadPool::ThreadPool(const std::size_t& count)
+{
+	for (std::size_t index = 0; index < count; ++index)
+		m_Workers.emplace_back(std::make_unique<Worker>());
+	for (std::size_t index = 0; index < count; ++index)
+		m_Threads.emplace_back(&ThreadPool::_Run, this, index);
+}
+
+ecs::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsRunning = false;
+	}
+	m_Condition.notify_all();
+	for (auto& thread : m_Threads)
+		thread.join();
+}
+
+std::size_t ecs::ThreadPool::GetWorkerIndex() const
+{
+	return (s_Pool == this) ? s_Index : m_Threads.size();
+}
+
+void ecs::ThreadPool::Submit(Task task, const std::size_t& worker, const bool& pinned)
+{
+	assert(worker < m_Workers.size() && "Worker index is out of range !");
+	{
+		std::lock_guard<std::mutex> lock(m_Workers[worker]->Mutex);
+		(pinned ? m_Workers[worker]->Pinned : m_Workers[worker]->Tasks).emplace_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_Generation;
+	}
+	m_Condition.notify_all();
+}
+
+void ecs::ThreadPool::_Run(const std::size_t& index)
+{
+	s_Pool = this;
+	s_Index = index;
+	Task task;
+	while (true)
+	{
+		std::size_t generation = 0u;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			generation = m_Generation;
+		}
+		if (_Take(index, task))
+		{
+			task();
+			continue;
+		}
+		/* Sleep until something new is submitted, queues could only contain tasks pinned to other workers */
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this, &generation]() { return !m_IsRunning || m_Generation != generation; });
+		if (!m_IsRunning)
+		{
+			lock.unlock();
+			while (_Take(index, task))
+				task();
+			return;
+		}
+	}
+}
+
+bool ecs::ThreadPool::_Take(const std::size_t& index, Task& task)
+{
+	/* Own queue first, newest task is the hottest one */
+	if (index < m_Workers.size())
+	{
+		auto& worker = *m_Workers[index];
+		std::lock_guard<std::mutex> lock(worker.Mutex);
+		for (auto queue : { &worker.Pinned, &worker.Tasks })
+		{
+			if (!queue->empty())
+			{
+				task = std::move(queue->back());
+				queue->pop_back();
+				return true;
+			}
+		}
+	}
+	/* Steal oldest task from other workers */
+	for (std::size_t offset = 1; offset <= m_Workers.size(); ++offset)
+	{
+		auto& victim = *m_Workers[(index + offset) % m_Workers.size()];
+		std::lock_guard<std::mutex> lock(victim.Mutex);
+		if (!victim.Tasks.empty())
+		{
+			task = std::move(victim.Tasks.front());
+			victim.Tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void ecs::ThreadPool::_Wait(const std::atomic<std::size_t>& remaining)
+{
+	const auto index = GetWorkerIndex();
+	Task task;
+	while (remaining.load(std::memory_order_acquire) != 0u)
+	{
+		std::size_t generation = 0u;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			generation = m_Generation;
+		}
+		if (_Take(index, task))
+		{
+			task();
+			continue;
+		}
+		/* Remaining chunks run on other threads, sleep until they are done or something new is submitted */
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [&remaining, &generation, this]() { return remaining.load(std::memory_order_acquire) == 0u || m_Generation != generation; });
+	}
+}
+
+void ecs::ThreadPool::_Finish()
+{
+	/* Waiter checks counter under the mutex, so taking it here makes sure the notification isn't lost */
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+	}
+	m_Condition.notify_all();
+}
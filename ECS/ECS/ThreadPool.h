@@ -0,0 +1,94 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include "Common.h"
+
+namespace ecs
+{
+	/* Parallel pass settings */
+	struct ParallelPolicy
+	{
+		/* Max count of elements in one chunk */
+		std::size_t Grain = 1024u;
+		/* If true, chunk always runs on the same worker (chunk index % workers count) and is never stolen */
+		bool Deterministic = false;
+	};
+	/* Work stealing thread pool, each worker takes tasks from the back of its own queue
+	   and steals from the front of other workers queues when own queue is empty */
+	class ThreadPool
+	{
+	public:
+		using Task = std::function<void()>;
+	private:
+		/* Worker queue */
+		struct Worker
+		{
+			std::mutex Mutex;
+			/* Tasks which can be stolen by other workers */
+			std::deque<Task> Tasks;
+			/* Tasks which are bound to this worker */
+			std::deque<Task> Pinned;
+		};
+	public:
+		ThreadPool(const std::size_t& count = std::thread::hardware_concurrency());
+		virtual ~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+	public:
+		/* Return count of worker threads */
+		std::size_t GetWorkersCount() const { return m_Threads.size(); }
+		/* Return index of current worker thread, or workers count if called outside of the pool */
+		std::size_t GetWorkerIndex() const;
+		/* Push task into worker queue, if pinned task will not be stolen by other workers */
+		void Submit(Task task, const std::size_t& worker, const bool& pinned = false);
+		/* Split [0, count) into chunks of given grain and call function(begin, end) for each of them.
+		   Calling thread helps to execute tasks and returns when all chunks are done */
+		template<typename Function>
+		void ParallelFor(const std::size_t& count, const ParallelPolicy& policy, Function function)
+		{
+			const auto grain = (std::max)(policy.Grain, std::size_t(1u));
+			const auto chunks = (count + grain - 1u) / grain;
+			if (chunks == 0u)
+				return;
+			if (chunks == 1u || m_Threads.empty())
+			{
+				for (std::size_t begin = 0; begin < count; begin += grain)
+					function(begin, (std::min)(begin + grain, count));
+				return;
+			}
+			std::atomic<std::size_t> remaining = chunks;
+			for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+			{
+				const auto begin = chunk * grain;
+				const auto end = (std::min)(begin + grain, count);
+				Submit([this, &function, &remaining, begin, end]()
+					{
+						function(begin, end);
+						if (remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+							_Finish();
+					}, chunk % m_Threads.size(), policy.Deterministic);
+			}
+			_Wait(remaining);
+		}
+	private:
+		std::vector<std::unique_ptr<Worker>> m_Workers;
+		std::vector<std::thread> m_Threads;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		/* Incremented on each submitted task, wakes up sleeping workers */
+		std::size_t m_Generation = 0u;
+		bool m_IsRunning = true;
+	private:
+		/* Worker thread loop */
+		void _Run(const std::size_t& index);
+		/* Take task from own queue or steal it from other workers */
+		bool _Take(const std::size_t& index, Task& task);
+		/* Execute pending tasks until counter reaches zero, sleep while there is nothing to help with */
+		void _Wait(const std::atomic<std::size_t>& remaining);
+		/* Wake up threads waiting for last chunk of parallel pass */
+		void _Finish();
+	};
+}
@@ -1,45 +1,59 @@
 #pragma once
-#include "Storage.h"
-#include "EntityManager.h"
+#include "Entity.h"
 
 namespace ecs
 {
-	class Entity;
-	/* View class that allow us to iterate through all entites with given set of components */
+	/* View class that allow us to iterate through all entites with given set of components,
+	   Optional<Component> doesn't restrict view and is passed as pointer */
 	template<typename Entity, typename... Component>
 	class BasicView
 	{
 	public:
-		using OtherPools = std::array<const SparseSet<Entity>*, (sizeof...(Component) - 1)>;
+		/* Count of components which entities of view must have */
+		static constexpr std::size_t Required = (std::size_t(!internal::IsOptional<Component>::value) + ...);
+		static_assert(Required != 0u, "View needs at least one required component !");
+		/* Signature bits of required components which aren't candidate */
+		using OtherPools = std::array<TypeID, (Required - 1)>;
+		/* Maximum count of excluded components */
+		static constexpr std::size_t MaxExcluded = 8u;
+		/* Signature bits of excluded pools, resolved once when view is created. Missing pools aren't kept, no entity has them */
+		struct ExcludedPools
+		{
+			std::array<std::size_t, MaxExcluded> Indices{};
+			std::size_t Size = 0u;
+		};
 		using Candidate = SparseSet<Entity>;
-		using Pools = std::vector<std::unique_ptr<Storage<Entity>>>;
+		using Pools = std::tuple<ComponentStorage<internal::Unwrap<Component>, Entity>*...>;
+		using Positions = std::array<std::size_t, sizeof...(Component)>;
+		/* Maximum count of rows passed to function at once by chunked iteration */
+		static constexpr std::size_t ChunkSize = internal::ChunkSize;
 		/* View iterator to to iterate through all valid entities with given set of components */
-		template<typename Entity>
+		template<typename Type>
 		class BasicViewIterator
 		{
 		public:
 			using iterator_category = std::random_access_iterator_tag;
 			using difference_type = std::ptrdiff_t;
-			using value_type = Entity;
+			using value_type = Type;
 			using pointer = value_type*;
 			using reference = value_type&;
 		public:
-			BasicViewIterator(pointer first = nullptr, pointer last = nullptr, EntityManager* manager = nullptr, const OtherPools pools = {}) :
-				m_First(first), m_Last(last), m_Current(first), m_Manager(manager), m_Pools(pools)
+			BasicViewIterator(pointer first = nullptr, pointer last = nullptr, EntityManager* manager = nullptr, const OtherPools pools = {}, const ExcludedPools excluded = {}) :
+				m_First(first), m_Last(last), m_Current(first), m_Pools(pools), m_Excluded(excluded), m_Manager(manager)
 			{
 				/* Make sure that first entity has set of given components */
 				if (m_Current != m_Last && !InOtherPools())
 					++(*this);
-				if(m_Current)
-					m_Entity.m_Handle = *m_Current;
+				if (m_Current && m_Current != m_Last)
+					m_Entity.m_Handle = m_Manager->_GetHandle(*m_Current);
 				m_Entity.m_Manager = m_Manager;
 			}
 			~BasicViewIterator() = default;
 		public:
-			BasicViewIterator& operator++(int) noexcept { while (++m_Current != m_Last && !InOtherPools()); m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			BasicViewIterator& operator--(int) noexcept { while (--m_Current != m_Last && !InOtherPools()); m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			BasicViewIterator& operator++() noexcept { while (++m_Current != m_Last && !InOtherPools()); m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
-			BasicViewIterator& operator--() noexcept { while (--m_Current != m_Last && !InOtherPools()); m_Entity.m_Handle = *m_Current; m_Entity.m_Manager = m_Manager; return (*this); }
+			BasicViewIterator& operator++(int) noexcept { while (++m_Current != m_Last && !InOtherPools()); return _Update(); }
+			BasicViewIterator& operator--(int) noexcept { while (--m_Current != m_Last && !InOtherPools()); return _Update(); }
+			BasicViewIterator& operator++() noexcept { while (++m_Current != m_Last && !InOtherPools()); return _Update(); }
+			BasicViewIterator& operator--() noexcept { while (--m_Current != m_Last && !InOtherPools()); return _Update(); }
 			bool operator==(const BasicViewIterator& other) const noexcept { return other.m_Current == m_Current; }
 			bool operator!=(const BasicViewIterator& other) const noexcept { return other.m_Current != m_Current; }
 			ecs::Entity& operator*() { return m_Entity; }
@@ -52,56 +66,191 @@ namespace ecs
 			pointer const m_Last;
 			pointer m_Current;
 			const OtherPools m_Pools;
+			const ExcludedPools m_Excluded;
 			EntityManager* const m_Manager;
 			ecs::Entity m_Entity;
 		private:
-			/* Check if entity exist in other needed pools*/
+			/* Check if entity exist in other needed pools and in none of excluded, only signature of entity is touched */
 			[[nodiscard]] bool InOtherPools() const
 			{
-				return std::all_of(m_Pools.cbegin(), m_Pools.cend(), [entt = *m_Current](const SparseSet<Entity>* current) { return current->Contains(entt); });
+				return std::all_of(m_Pools.cbegin(), m_Pools.cend(), [this, entt = *m_Current](const TypeID& index) { return m_Manager->_HasComponent(entt, index); }) &&
+					std::none_of(m_Excluded.Indices.cbegin(), m_Excluded.Indices.cbegin() + m_Excluded.Size, [this, entt = *m_Current](const std::size_t& index) { return m_Manager->_HasComponent(entt, index); });
+			}
+			BasicViewIterator& _Update() noexcept
+			{
+				if (m_Current != m_Last)
+					m_Entity.m_Handle = m_Manager->_GetHandle(*m_Current);
+				m_Entity.m_Manager = m_Manager;
+				return (*this);
 			}
 		};
 	public:
 		using iterator = BasicViewIterator<Entity>;
 		using const_iterator = BasicViewIterator<const Entity>;
 	public:
-		BasicView(const SparseSet<Entity>* candidate = nullptr, const Pools* pools = nullptr, EntityManager* manager = nullptr):
-			m_Candidate(candidate), m_Pools(pools), m_Manager(manager)
+		BasicView(const SparseSet<Entity>* candidate = nullptr, const Pools& pools = {}, EntityManager* manager = nullptr, const std::pmr::vector<Entity>* filter = nullptr, const ExcludedPools excluded = {}):
+			m_Candidate(candidate), m_Pools(pools), m_Manager(manager), m_Filter(filter), m_Excluded(excluded)
 		{}
 		virtual ~BasicView() = default;
+		/* Return view of entities which given component was added or changed during current tick, changed list of the pool
+		   is iterated instead of whole pool. Component must be tracked (see ComponentTraits::TrackChanges) */
+		template<typename Tracked>
+		BasicView Changed() const
+		{
+			static_assert((std::is_same_v<Tracked, Component> || ...), "Component isn't part of view !");
+			static_assert(internal::IsTracked<Tracked>::value, "Component isn't tracked !");
+			const auto pool = std::get<ComponentStorage<Tracked, Entity>*>(m_Pools);
+			return (m_Candidate && pool) ? BasicView(pool, m_Pools, m_Manager, &pool->GetChanges()->Changed, m_Excluded) : BasicView(nullptr, m_Pools, m_Manager);
+		}
 		/* Execute for each entity with given set of components */
 		template<typename Function>
 		void Each(Function function)
 		{
-			for (auto& entity : *this)
-				function(entity, m_Manager->GetComponent<Component>(entity)...);
+			if (m_Candidate)
+				_Each(function, 0u, _GetSize(), std::index_sequence_for<Component...>{});
+		}
+		/* Execute for each entity with given set of components on thread pool, candidate pool is split into chunks of policy grain.
+		   Function is called concurrently, no entities or components can be created or removed during the pass */
+		template<typename Function>
+		void ParallelEach(Function function, const ParallelPolicy& policy = {})
+		{
+			if (!m_Candidate)
+				return;
+			const internal::ParallelPass pass(m_Manager->m_ParallelDepth);
+			m_Manager->GetThreadPool().ParallelFor(_GetSize(), policy, [this, &function](const std::size_t& begin, const std::size_t& end)
+				{
+					_Each(function, begin, end, std::index_sequence_for<Component...>{});
+				});
+		}
+		/* Execute for chunks of entities with given set of components, function takes (Span<const Entity> entities, Chunk... components).
+		   Entities are ids without version as kept in pools. Chunk is Span of components, or tuple of Spans of columns for component stored in columns (see ColumnStorage.h).
+		   Rows of chunk are consecutive in every pool, so chunk ends where order of pools differs, e.g. pools sorted the same way give long chunks.
+		   Chunk has at most ChunkSize rows, optional components and components with stable references can't be part of chunk */
+		template<typename Function>
+		void EachChunk(Function function)
+		{
+			if (m_Candidate)
+				_EachChunk(function, 0u, _GetSize(), std::index_sequence_for<Component...>{});
+		}
+		/* Execute for chunks of entities on thread pool, each task of policy grain is split into its own chunks.
+		   Function is called concurrently, no entities or components can be created or removed during the pass */
+		template<typename Function>
+		void ParallelEachChunk(Function function, const ParallelPolicy& policy = {})
+		{
+			if (!m_Candidate)
+				return;
+			const internal::ParallelPass pass(m_Manager->m_ParallelDepth);
+			m_Manager->GetThreadPool().ParallelFor(_GetSize(), policy, [this, &function](const std::size_t& begin, const std::size_t& end)
+				{
+					_EachChunk(function, begin, end, std::index_sequence_for<Component...>{});
+				});
 		}
 	public:
 		/* Begin of view iterator */
-		iterator begin() noexcept { return iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+		iterator begin() noexcept { return iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools), m_Excluded); };
 		/* End of view iterator */
-		iterator end() noexcept { return iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+		iterator end() noexcept { return iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools), m_Excluded); };
 		/* Const begin of view iterator */
-		const_iterator cbegin() const noexcept { return const_iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+		const_iterator cbegin() const noexcept { return const_iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools), m_Excluded); };
 		/* Const end of view iterator */
-		const_iterator cend() const noexcept { return const_iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+		const_iterator cend() const noexcept { return const_iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools), m_Excluded); };
 	private:
 		const Candidate* m_Candidate;
-		const Pools* m_Pools;
+		const Pools m_Pools;
 		EntityManager* const m_Manager;
+		/* Entities to iterate instead of candidate pool, all of them are in candidate pool */
+		const std::pmr::vector<Entity>* const m_Filter;
+		/* Components which entities of view mustn't have */
+		const ExcludedPools m_Excluded;
 	private:
-		const Entity* _EntitiesBegin() const noexcept { return (m_Candidate) ? m_Candidate->GetData() : nullptr; };
-		const Entity* _EntitiesEnd()   const noexcept { return (m_Candidate) ? m_Candidate->GetData() + m_Candidate->GetSize() : nullptr; };
+		const Entity* _EntitiesBegin() const noexcept { return (m_Candidate) ? (m_Filter ? m_Filter->data() : m_Candidate->GetData()) : nullptr; };
+		const Entity* _EntitiesEnd()   const noexcept { return (m_Candidate) ? _EntitiesBegin() + _GetSize() : nullptr; };
+		std::size_t _GetSize() const noexcept { return m_Filter ? m_Filter->size() : m_Candidate->GetSize(); }
 		Entity* _EntitiesBegin() noexcept { return const_cast<Entity*>(const_cast<const BasicView*>(this)->_EntitiesBegin()); };
 		Entity* _EntitiesEnd()  noexcept { return const_cast<Entity*>(const_cast<const BasicView*>(this)->_EntitiesEnd()); };
 
-		/* Prepare pools of needed components */
-		[[nodiscard]] OtherPools PrepareOtherPools(const Candidate* candidate, const Pools* pools) const
+		/* Prepare pools of needed components, optional ones aren't needed */
+		[[nodiscard]] OtherPools PrepareOtherPools(const Candidate* candidate, const Pools& pools) const
 		{
 			std::size_t position = 0; OtherPools others{};
 			if (candidate)
-				((static_cast<const SparseSet<Entity>*>((*pools)[TypeInfo<Component>::ID()].get()) == candidate ? nullptr : (others[position] = static_cast<const SparseSet<Entity>*>((*pools)[TypeInfo<Component>::ID()].get()), others[position++])), ...);
+				std::apply([&](const auto*... pool) { ((internal::IsOptional<Component>::value || static_cast<const SparseSet<Entity>*>(pool) == candidate ? void() : void(others[position++] = pool->GetIndex())), ...); }, pools);
 			return others;
 		}
+		/* Return position of entity in pool, optional pool may not exist */
+		template<typename Pool>
+		static std::size_t _Find(const Pool* pool, const Entity& entity) { return pool ? pool->Find(entity) : Candidate::Tombstone; }
+		/* Return true if entity has any of excluded components */
+		bool _IsExcluded(const Entity& entity) const
+		{
+			return std::any_of(m_Excluded.Indices.cbegin(), m_Excluded.Indices.cbegin() + m_Excluded.Size, [this, &entity](const std::size_t& index) { return m_Manager->_HasComponent(entity, index); });
+		}
+		/* Return component reference, or pointer for optional component */
+		template<typename Type, typename Pool>
+		static decltype(auto) _Fetch(Pool* pool, const std::size_t& position)
+		{
+			if constexpr (internal::IsOptional<Type>::value)
+				return (position != Candidate::Tombstone) ? &pool->GetAt(position) : static_cast<internal::Unwrap<Type>*>(nullptr);
+			else
+				return (pool->GetAt(position));
+		}
+		/* Iterate through candidate by index, components are taken directly by position in each pool */
+		template<typename Function, std::size_t... Index>
+		void _Each(Function& function, const std::size_t& begin, const std::size_t& end, std::index_sequence<Index...>)
+		{
+			/* Index of pool which is candidate, its position is already known */
+			std::size_t candidate = 0;
+			((!internal::IsOptional<Component>::value && static_cast<const SparseSet<Entity>*>(std::get<Index>(m_Pools)) == m_Candidate ? void(candidate = Index) : void()), ...);
+
+			const auto entities = _EntitiesBegin();
+			const auto others = PrepareOtherPools(m_Candidate, m_Pools);
+			ecs::Entity entity(ecs::null, m_Manager);
+			Positions positions;
+			for (auto position = begin; position < end; ++position)
+			{
+				const auto current = entities[position];
+				/* Entities without all components or with excluded ones are rejected by signature, before any sparse lookup */
+				if (!std::all_of(others.cbegin(), others.cend(), [this, current](const TypeID& index) { return m_Manager->_HasComponent(current, index); }) || _IsExcluded(current))
+					continue;
+				/* One sparse lookup per component, missing optional component doesn't reject entity */
+				if (((positions[Index] = (Index == candidate) ? (m_Filter ? m_Candidate->GetPosition(current) : position) : _Find(std::get<Index>(m_Pools), current),
+					internal::IsOptional<Component>::value || positions[Index] != Candidate::Tombstone) && ...))
+				{
+					entity.m_Handle = m_Manager->_GetHandle(current);
+					function(entity, _Fetch<Component>(std::get<Index>(m_Pools), positions[Index])...);
+				}
+			}
+		}
+		/* Iterate through candidate by index and pass runs of rows which are consecutive in all pools.
+		   Only first entity of chunk is looked up, chunk is extended while next entity is next in tightly packed array of each pool */
+		template<typename Function, std::size_t... Index>
+		void _EachChunk(Function& function, const std::size_t& begin, const std::size_t& end, std::index_sequence<Index...>)
+		{
+			static_assert(!(internal::IsOptional<Component>::value || ...), "Optional component can't be part of chunk !");
+			const auto entities = _EntitiesBegin();
+			const auto others = PrepareOtherPools(m_Candidate, m_Pools);
+			/* First row of chunk in each pool */
+			Positions first;
+			for (auto position = begin; position < end;)
+			{
+				const auto current = entities[position];
+				if (!std::all_of(others.cbegin(), others.cend(), [this, current](const TypeID& index) { return m_Manager->_HasComponent(current, index); }) || _IsExcluded(current))
+				{
+					++position;
+					continue;
+				}
+				/* Signature guarantees that entity is in all pools */
+				((first[Index] = (!m_Filter && static_cast<const SparseSet<Entity>*>(std::get<Index>(m_Pools)) == m_Candidate) ? position : std::get<Index>(m_Pools)->GetPosition(current)), ...);
+				/* Rows of unfiltered candidate are consecutive by definition */
+				const std::array<bool, sizeof...(Component)> compared = { (m_Filter || static_cast<const SparseSet<Entity>*>(std::get<Index>(m_Pools)) != m_Candidate)... };
+				const auto limit = (std::min)(ChunkSize, end - position);
+				std::size_t count = 1u;
+				while (count < limit && ((!compared[Index] || (first[Index] + count < std::get<Index>(m_Pools)->GetSize() && std::get<Index>(m_Pools)->GetData()[first[Index] + count] == entities[position + count])) && ...) &&
+					(m_Excluded.Size == 0u || !_IsExcluded(entities[position + count])))
+					++count;
+				function(Span<const Entity>(entities + position, count), std::get<Index>(m_Pools)->GetChunk(first[Index], count)...);
+				position += count;
+			}
+		}
 	};
 }
@@ -51,18 +51,20 @@ int main()
 	entityManager.OnUpdateSystem<std::string>();
 	entityManager.OnUpdateSystem<std::size_t>();
 
-	entityManager.View<std::string, std::size_t>().Each([](ecs::Entity& entity, std::string& str, std::size_t& value)
+	entityManager.View<std::string, std::size_t>().Each([](ecs::Entity&, std::string& str, std::size_t& value)
 		{
 			std::cout << str << " value: " << value << "\n";
 
 		});
 
 
-	//entityManager.View<std::string>().Each([](ecs::Entity& entity, std::string& str)
-	//	{
-	//		//TODO need to rewrite sparse set iterator, and try iterate by index, see entt::sparse_set
-	//		//entity.RemoveComponent<std::string>();
-	//	});
+	/* Structural changes during iteration are recorded and played back after it */
+	ecs::CommandBuffer commands;
+	entityManager.View<std::string>().Each([&commands](ecs::Entity& entity, std::string&)
+		{
+			commands.RemoveComponent<std::string>(entity);
+		});
+	commands.Flush(entityManager);
 
 	
 
@@ -0,0 +1,121 @@
+#include "Test.h"
+
+/* Lists of added, changed and removed entities of tracked pools */
+
+namespace
+{
+	struct Score { int Value; };
+	/* Untracked component of the same size */
+	struct Plain { int Value; };
+	/* Return true if list contains entity exactly once */
+	bool ContainsOnce(const std::pmr::vector<ecs::EntityID>& list, const ecs::Entity& entity)
+	{
+		return std::count(list.cbegin(), list.cend(), entity.GetID()) == 1;
+	}
+}
+
+namespace ecs
+{
+	/* Traits which set only TrackChanges, other members take their defaults */
+	template<>
+	struct ComponentTraits<Score>
+	{
+		static constexpr bool TrackChanges = true;
+	};
+}
+
+ECS_TEST(AddAndRemoveInOneTick)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Score>(1);
+	entity.RemoveComponent<Score>();
+	ECS_CHECK(manager.GetAdded<Score>().empty());
+	ECS_CHECK(manager.GetChanged<Score>().empty());
+	ECS_CHECK(ContainsOnce(manager.GetRemoved<Score>(), entity));
+}
+
+ECS_TEST(RemoveKeepsOtherChanges)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int value = 0; value < 8; ++value)
+		entities.emplace_back(manager.CreateEntity()).AddComponent<Score>(value);
+	manager.AdvanceTick();
+	/* Entities 0-3 are changed in next tick, 4-7 are added again */
+	for (std::size_t index = 0; index < 4u; ++index)
+		entities[index].MarkChanged<Score>();
+	for (std::size_t index = 4; index < 8u; ++index)
+	{
+		entities[index].RemoveComponent<Score>();
+		entities[index].AddComponent<Score>(static_cast<int>(index));
+	}
+	manager.Sort<Score>([](const Score& left, const Score& right) { return left.Value > right.Value; });
+	for (const auto index : { 0u, 2u, 5u, 7u })
+		entities[index].RemoveComponent<Score>();
+	const auto& added = manager.GetAdded<Score>();
+	const auto& changed = manager.GetChanged<Score>();
+	ECS_CHECK(added.size() == 2u && ContainsOnce(added, entities[4]) && ContainsOnce(added, entities[6]));
+	ECS_CHECK(changed.size() == 4u);
+	for (const auto index : { 1u, 3u, 4u, 6u })
+		ECS_CHECK(ContainsOnce(changed, entities[index]));
+	/* Positions of moved entities are kept, so they can be removed later */
+	for (const auto index : { 1u, 3u, 4u, 6u })
+		entities[index].RemoveComponent<Score>();
+	ECS_CHECK(added.empty() && changed.empty());
+}
+
+ECS_TEST(DestroyAllEntitiesClearsAdded)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Score>(1);
+	manager.DestroyAllEntites();
+	ECS_CHECK(manager.GetAdded<Score>().empty());
+	ECS_CHECK(manager.GetChanged<Score>().empty());
+	ECS_CHECK(manager.GetRemoved<Score>().size() == 1u);
+}
+
+ECS_TEST(AdvanceTickStartsEmpty)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Score>(1);
+	manager.AdvanceTick();
+	entity.RemoveComponent<Score>();
+	ECS_CHECK(manager.GetAdded<Score>().empty());
+	ECS_CHECK(ContainsOnce(manager.GetRemoved<Score>(), entity));
+	entity.AddComponent<Score>(2);
+	ECS_CHECK(ContainsOnce(manager.GetAdded<Score>(), entity));
+	ECS_CHECK(ContainsOnce(manager.GetChanged<Score>(), entity));
+}
+
+ECS_TEST(TrackedPoolUsesResource)
+{
+	/* Lists of changes are allocated from resource of the pool */
+	std::array<std::byte, 1u << 16u> buffer;
+	std::pmr::monotonic_buffer_resource monotonic(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+	ecs::ComponentStorage<Score, ecs::EntityID> pool(&monotonic);
+	for (ecs::EntityID entity = 0; entity < 64u; ++entity)
+		pool.Add(entity, static_cast<int>(entity));
+	pool.Remove(ecs::EntityID(3u));
+	const auto changes = pool.GetChanges();
+	ECS_CHECK(changes->Slots.get_allocator().resource() == &monotonic);
+	ECS_CHECK(changes->Added.get_allocator().resource() == &monotonic && changes->Changed.get_allocator().resource() == &monotonic);
+	ECS_CHECK(changes->Removed.get_allocator().resource() == &monotonic);
+
+	/* Tracked pool takes more memory from manager resource than untracked one, nothing is left after manager is destroyed */
+	ecs::test::CountingResource tracked;
+	ecs::test::CountingResource untracked;
+	{
+		ecs::EntityManager trackedManager(&tracked);
+		ecs::EntityManager untrackedManager(&untracked);
+		for (int index = 0; index < 256; ++index)
+		{
+			trackedManager.CreateEntity().AddComponent<Score>(index);
+			untrackedManager.CreateEntity().AddComponent<Plain>(index);
+		}
+		ECS_CHECK(tracked.GetAllocated() >= untracked.GetAllocated() + 256u * (sizeof(ecs::internal::ChangeSlot) + 2u * sizeof(ecs::EntityID)));
+	}
+	ECS_CHECK(tracked.GetAllocations() == 0u && untracked.GetAllocations() == 0u);
+}
@@ -0,0 +1,48 @@
+#include "Test.h"
+
+/* Components stored in columns */
+
+namespace
+{
+	struct Particle
+	{
+		float X, Y;
+		int Life;
+	};
+}
+
+namespace ecs
+{
+	/* Traits which list only fields, other members take their defaults */
+	template<>
+	struct ComponentTraits<Particle>
+	{
+		static constexpr auto Fields = std::make_tuple(&Particle::X, &Particle::Y, &Particle::Life);
+	};
+}
+
+static_assert(ecs::internal::IsColumnar<Particle>, "Particle is stored in columns");
+static_assert(!ecs::internal::IsStable<Particle>::value && !ecs::internal::IsTracked<Particle>::value, "Missing traits take their defaults");
+
+ECS_TEST(FieldsOnlyTraits)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 4; ++index)
+		entities.emplace_back(manager.CreateEntity()).AddComponent<Particle>(static_cast<float>(index), 0.f, index);
+	entities[1].RemoveComponent<Particle>();
+	auto [x, y, life] = entities[3].GetComponent<Particle>();
+	ECS_CHECK(x == 3.f && y == 0.f && life == 3);
+	life = 30;
+	std::size_t rows = 0u;
+	int lives = 0;
+	manager.View<Particle>().EachChunk([&](ecs::Span<const ecs::EntityID> chunk, auto columns)
+		{
+			const auto [positionsX, positionsY, chunkLives] = columns;
+			ECS_CHECK(reinterpret_cast<std::uintptr_t>(positionsX.data()) % ecs::internal::ColumnAlignment == 0u);
+			rows += chunk.size();
+			for (std::size_t row = 0; row < chunk.size(); ++row)
+				lives += chunkLives[row];
+		});
+	ECS_CHECK(rows == 3u && lives == 32);
+}
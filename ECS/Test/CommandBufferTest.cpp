@@ -0,0 +1,135 @@
+#include "Test.h"
+
+/* Recorded structural changes and their play back */
+
+namespace
+{
+	struct Health { int Value; };
+	struct Tag { int Value; };
+}
+
+namespace ecs
+{
+	template<>
+	struct ComponentTraits<Health>
+	{
+		static constexpr bool TrackChanges = true;
+	};
+}
+
+ECS_TEST(CommandBufferAddReplacesComponent)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Health>(1);
+	manager.AdvanceTick();
+	ecs::CommandBuffer commands;
+	commands.AddComponent<Health>(entity, 2);
+	commands.Flush(manager);
+	ECS_CHECK(entity.GetComponent<Health>().Value == 2);
+	/* Replaced component is marked changed, not added again */
+	ECS_CHECK(manager.GetAdded<Health>().empty());
+	const auto& changed = manager.GetChanged<Health>();
+	ECS_CHECK(changed.size() == 1u && changed.front() == entity.GetID());
+	ECS_CHECK(commands.IsEmpty());
+}
+
+ECS_TEST(CommandBufferRemoveFromPending)
+{
+	ecs::EntityManager manager;
+	ecs::CommandBuffer commands;
+	const auto pending = commands.CreateEntity();
+	commands.AddComponent<Health>(pending, 1);
+	commands.AddComponent<Tag>(pending, 2);
+	commands.RemoveComponent<Health>(pending);
+	commands.Flush(manager);
+	std::size_t count = 0;
+	for (const auto handle : manager)
+	{
+		ecs::Entity entity(handle, &manager);
+		++count;
+		ECS_CHECK(!entity.HasComponent<Health>());
+		ECS_CHECK(entity.HasComponent<Tag>() && entity.GetComponent<Tag>().Value == 2);
+	}
+	ECS_CHECK(count == 1u);
+	ECS_CHECK(manager.GetAdded<Health>().empty());
+}
+
+ECS_TEST(CommandBufferSkipsStaleHandle)
+{
+	ecs::EntityManager manager;
+	ecs::Entity stale = manager.CreateEntity();
+	const ecs::EntityID handle = stale.GetID();
+	ecs::CommandBuffer commands;
+	commands.AddComponent<Tag>(handle, 1);
+	commands.RemoveComponent<Health>(handle);
+	commands.DestroyEntity(handle);
+	stale.Destroy();
+	/* Slot of destroyed entity is reused with new version */
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Health>(3);
+	ECS_CHECK(!ecs::Entity(handle, &manager).IsValid());
+	commands.Flush(manager);
+	ECS_CHECK(entity.IsValid());
+	ECS_CHECK(!entity.HasComponent<Tag>());
+	ECS_CHECK(entity.HasComponent<Health>() && entity.GetComponent<Health>().Value == 3);
+	ECS_CHECK(commands.IsEmpty());
+}
+
+ECS_TEST(CommandBufferDestroysLast)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Health>(1);
+	manager.AdvanceTick();
+	ecs::CommandBuffer commands;
+	/* Destroy is recorded before add, but entity is destroyed after component commands */
+	commands.DestroyEntity(entity);
+	commands.AddComponent<Tag>(entity, 1);
+	const auto pending = commands.CreateEntity();
+	commands.DestroyEntity(pending);
+	commands.AddComponent<Health>(pending, 2);
+	commands.Flush(manager);
+	ECS_CHECK(!entity.IsValid());
+	ECS_CHECK(manager.begin() == manager.end());
+	/* Pending entity received its component before it was destroyed */
+	ECS_CHECK(manager.GetAdded<Health>().empty());
+	ECS_CHECK(manager.GetRemoved<Health>().size() == 2u);
+}
+
+ECS_TEST(CommandBufferFlushesBuffersInOrder)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	ecs::Entity kept = manager.CreateEntity();
+	std::vector<ecs::CommandBuffer> buffers(3);
+	/* Commands of later buffers are applied after commands of earlier buffers */
+	buffers[2].AddComponent<Tag>(kept, 2);
+	buffers[0].AddComponent<Tag>(kept, 0);
+	buffers[1].AddComponent<Tag>(kept, 1);
+	buffers[0].DestroyEntity(entity);
+	buffers[1].AddComponent<Tag>(entity, 1);
+	for (std::size_t index = 0; index < buffers.size(); ++index)
+	{
+		for (std::size_t count = 0; count <= index; ++count)
+			buffers[index].AddComponent<Tag>(buffers[index].CreateEntity(), static_cast<int>(index * 10u + count));
+	}
+	ecs::CommandBuffer::Flush(manager, buffers.begin(), buffers.end());
+	ECS_CHECK(!entity.IsValid());
+	ECS_CHECK(kept.GetComponent<Tag>().Value == 2);
+	/* Pending entities of all buffers are created in one batch in order of buffers */
+	std::vector<std::pair<ecs::EntityID, int>> created;
+	for (const auto handle : manager)
+	{
+		ecs::Entity current(handle, &manager);
+		if (current != kept)
+			created.emplace_back(current.GetID(), current.GetComponent<Tag>().Value);
+	}
+	std::sort(created.begin(), created.end());
+	std::vector<int> values;
+	for (const auto& [handle, value] : created)
+		values.push_back(value);
+	ECS_CHECK(values == std::vector<int>{ 0, 10, 11, 20, 21, 22 });
+	for (const auto& buffer : buffers)
+		ECS_CHECK(buffer.IsEmpty());
+}
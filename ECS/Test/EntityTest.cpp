@@ -0,0 +1,68 @@
+#include "Test.h"
+
+/* Versioned entity handles and lookup of components through them */
+
+namespace
+{
+	struct Health { int Value; };
+	struct Armor { int Value; };
+}
+
+ECS_TEST(TryGetRejectsRecycledHandle)
+{
+	ecs::EntityManager manager;
+	ecs::Entity old = manager.CreateEntity();
+	old.AddComponent<Health>(1);
+	const auto stale = static_cast<ecs::EntityID>(old);
+	ECS_CHECK(ecs::Entity(stale, &manager).TryGet<Health>() && ecs::Entity(stale, &manager).TryGet<Health>()->Value == 1);
+	old.Destroy();
+	ECS_CHECK(ecs::Entity(stale, &manager).TryGet<Health>() == nullptr);
+
+	/* Slot is reused with next version, old handle stays invalid */
+	ecs::Entity recycled = manager.CreateEntity();
+	recycled.AddComponent<Health>(2);
+	const auto current = static_cast<ecs::EntityID>(recycled);
+	ECS_CHECK(recycled.GetID() == ecs::EntityTraits<ecs::EntityID>::ToID(stale) && current != stale);
+	ECS_CHECK(recycled.GetVersion() == 1u);
+	ECS_CHECK(!ecs::Entity(stale, &manager).IsValid() && recycled.IsValid());
+	ECS_CHECK(ecs::Entity(stale, &manager).TryGet<Health>() == nullptr);
+	ECS_CHECK(ecs::Entity(current, &manager).TryGet<Health>() && ecs::Entity(current, &manager).TryGet<Health>()->Value == 2);
+	ECS_CHECK(recycled.TryGet<Health>() == &recycled.GetComponent<Health>());
+}
+
+ECS_TEST(TryGetMissingComponent)
+{
+	ecs::EntityManager manager;
+	ecs::Entity entity = manager.CreateEntity();
+	/* Pool doesn't exist, then entity isn't in existing pool */
+	ECS_CHECK(entity.TryGet<Armor>() == nullptr);
+	manager.CreateEntity().AddComponent<Armor>(1);
+	ECS_CHECK(entity.TryGet<Armor>() == nullptr);
+	entity.AddComponent<Armor>(2);
+	ECS_CHECK(entity.TryGet<Armor>() && entity.TryGet<Armor>()->Value == 2);
+	entity.RemoveComponent<Armor>();
+	ECS_CHECK(entity.TryGet<Armor>() == nullptr);
+	/* Null handle and handle of id which was never created */
+	ECS_CHECK(ecs::Entity(ecs::null, &manager).TryGet<Armor>() == nullptr);
+	ECS_CHECK(ecs::Entity(ecs::EntityID(1000u), &manager).TryGet<Armor>() == nullptr);
+	ECS_CHECK(ecs::Entity().TryGet<Armor>() == nullptr);
+}
+
+ECS_TEST(VersionGrowsWithEachRecycle)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::EntityID> handles;
+	for (int round = 0; round < 4; ++round)
+	{
+		ecs::Entity entity = manager.CreateEntity();
+		entity.AddComponent<Health>(round);
+		handles.push_back(static_cast<ecs::EntityID>(entity));
+		ECS_CHECK(entity.GetID() == 0u && entity.GetVersion() == static_cast<ecs::EntityVersion>(round));
+		entity.Destroy();
+	}
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<Health>(4);
+	for (const auto& handle : handles)
+		ECS_CHECK(ecs::Entity(handle, &manager).TryGet<Health>() == nullptr);
+	ECS_CHECK(entity.TryGet<Health>()->Value == 4);
+}
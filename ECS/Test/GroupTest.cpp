@@ -0,0 +1,110 @@
+#include "Test.h"
+
+/* Owning groups keep entities with all owned components at [0, Size) of each owned pool */
+
+namespace
+{
+	struct A { std::size_t Id; };
+	struct B { std::size_t Id; };
+	struct C { int Value; };
+
+	/* Return ids of entities visited by each */
+	template<typename Range>
+	std::vector<std::size_t> GetIds(Range range)
+	{
+		std::vector<std::size_t> ids;
+		range.Each([&ids](ecs::Entity& entity, A&, B&) { ids.push_back(entity.GetID()); });
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+	/* Return true if group contains the same entities as view and rows of owned pools belong to the same entity */
+	bool MatchesView(ecs::EntityManager& manager)
+	{
+		auto group = manager.Group<A, B>();
+		bool aligned = true;
+		group.Each([&aligned](ecs::Entity& entity, A& a, B& b) { aligned = aligned && a.Id == entity.GetID() && b.Id == entity.GetID(); });
+		const auto ids = GetIds(group);
+		return aligned && group.GetSize() == ids.size() && ids == GetIds(manager.View<A, B>());
+	}
+}
+
+ECS_TEST(GroupFollowsStructuralChanges)
+{
+	ecs::EntityManager manager;
+	ECS_CHECK(manager.Group<A, B>().IsEmpty());
+	std::vector<ecs::Entity> entities;
+	for (std::size_t index = 0; index < 64u; ++index)
+	{
+		auto& entity = entities.emplace_back(manager.CreateEntity());
+		if (index % 2u == 0u)
+			entity.AddComponent<A>(entity.GetID());
+		if (index % 3u == 0u)
+			entity.AddComponent<B>(entity.GetID());
+		entity.AddComponent<C>(0);
+	}
+	ECS_CHECK(MatchesView(manager));
+	ECS_CHECK(manager.Group<A, B>().GetSize() == 11u);
+
+	/* Interleaved adds, removes and destroys, ids follow simple pattern so each step touches members and non members */
+	for (std::size_t index = 0; index < entities.size(); ++index)
+	{
+		auto& entity = entities[index];
+		switch (index % 5u)
+		{
+		case 0u:
+			if (entity.HasComponent<A>())
+				entity.RemoveComponent<A>();
+			break;
+		case 1u:
+			if (!entity.HasComponent<A>())
+				entity.AddComponent<A>(entity.GetID());
+			if (!entity.HasComponent<B>())
+				entity.AddComponent<B>(entity.GetID());
+			break;
+		case 2u:
+			entity.Destroy();
+			break;
+		case 3u:
+			if (entity.HasComponent<B>())
+				entity.RemoveComponent<B>();
+			break;
+		default:
+			entity.RemoveComponent<C>();
+			break;
+		}
+		ECS_CHECK(MatchesView(manager));
+	}
+
+	/* Batch insert */
+	std::vector<ecs::EntityID> created;
+	manager.CreateEntities(16u, std::back_inserter(created));
+	std::vector<A> values;
+	for (const auto& handle : created)
+		values.push_back({ ecs::EntityTraits<ecs::EntityID>::ToID(handle) });
+	manager.Insert<A>(created.cbegin(), created.cend(), values.cbegin());
+	for (std::size_t index = 0; index < created.size(); index += 2u)
+		ecs::Entity(created[index], &manager).AddComponent<B>(ecs::EntityTraits<ecs::EntityID>::ToID(created[index]));
+	ECS_CHECK(MatchesView(manager));
+
+	/* Deferred changes */
+	ecs::CommandBuffer commands;
+	const auto pending = commands.CreateEntity();
+	commands.AddComponent<A>(pending, std::size_t(0u));
+	commands.AddComponent<B>(pending, std::size_t(0u));
+	commands.RemoveComponent<B>(created[0]);
+	commands.DestroyEntity(created[2]);
+	commands.Flush(manager);
+	manager.Group<A, B>().Each([](ecs::Entity& entity, A& a, B& b)
+		{
+			if (a.Id == 0u && entity.GetID() != 0u)
+				a.Id = b.Id = entity.GetID();
+		});
+	ECS_CHECK(MatchesView(manager));
+
+	manager.DestroyAllEntites();
+	ECS_CHECK(manager.Group<A, B>().IsEmpty() && MatchesView(manager));
+	ecs::Entity entity = manager.CreateEntity();
+	entity.AddComponent<A>(entity.GetID());
+	entity.AddComponent<B>(entity.GetID());
+	ECS_CHECK(manager.Group<A, B>().GetSize() == 1u && MatchesView(manager));
+}
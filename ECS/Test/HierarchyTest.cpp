@@ -0,0 +1,167 @@
+#include "Test.h"
+
+/* Parent and children links of entities */
+
+namespace
+{
+	/* Return children of entity in order of children iterator */
+	std::vector<ecs::EntityID> Children(ecs::Entity& entity)
+	{
+		std::vector<ecs::EntityID> children;
+		for (auto& child : entity)
+			children.push_back(child.GetID());
+		return children;
+	}
+	/* Return true if every child of entity has it as parent */
+	bool ParentOfChildren(ecs::Entity& entity)
+	{
+		bool result = true;
+		for (auto& child : entity)
+			result = result && child.GetParent() == entity;
+		return result;
+	}
+}
+
+ECS_TEST(HierarchyReparent)
+{
+	ecs::EntityManager manager;
+	ecs::Entity first = manager.CreateEntity();
+	ecs::Entity second = manager.CreateEntity();
+	ecs::Entity child = manager.CreateEntity();
+	ecs::Entity other = manager.CreateEntity();
+	first.AddChild(child);
+	first.AddChild(other);
+	ecs::Entity last = manager.CreateEntity();
+	second.AddChild(last);
+	/* Child is unlinked from old parent and appended to children of new parent */
+	child.SetParent(second);
+	ECS_CHECK(child.IsChildOf(second) && !child.IsChildOf(first));
+	ECS_CHECK(Children(first) == std::vector<ecs::EntityID>{ other.GetID() });
+	ECS_CHECK(Children(second) == std::vector<ecs::EntityID>{ last.GetID(), child.GetID() });
+	ECS_CHECK(ParentOfChildren(first) && ParentOfChildren(second));
+	child.UnsetParent();
+	ECS_CHECK(!child.HasParent());
+	ECS_CHECK(Children(second) == std::vector<ecs::EntityID>{ last.GetID() } && ParentOfChildren(second));
+}
+
+ECS_TEST(HierarchyUnlinkChildren)
+{
+	ecs::EntityManager manager;
+	ecs::Entity parent = manager.CreateEntity();
+	std::vector<ecs::Entity> children;
+	for (int index = 0; index < 5; ++index)
+		parent.AddChild(children.emplace_back(manager.CreateEntity()));
+	/* Middle, first and last child */
+	parent.RemoveChild(children[2]);
+	ECS_CHECK(Children(parent) == std::vector<ecs::EntityID>{ children[0].GetID(), children[1].GetID(), children[3].GetID(), children[4].GetID() });
+	parent.RemoveChild(children[0]);
+	ECS_CHECK(Children(parent) == std::vector<ecs::EntityID>{ children[1].GetID(), children[3].GetID(), children[4].GetID() });
+	parent.RemoveChild(children[4]);
+	ECS_CHECK(Children(parent) == std::vector<ecs::EntityID>{ children[1].GetID(), children[3].GetID() });
+	ECS_CHECK(ParentOfChildren(parent));
+	for (const auto index : { 0u, 2u, 4u })
+		ECS_CHECK(!children[index].HasParent() && children[index].IsValid());
+	/* Removed children can be added again at the end */
+	parent.AddChild(children[0]);
+	ECS_CHECK(Children(parent) == std::vector<ecs::EntityID>{ children[1].GetID(), children[3].GetID(), children[0].GetID() });
+	parent.RemoveChild(children[1]);
+	parent.RemoveChild(children[3]);
+	parent.RemoveChild(children[0]);
+	ECS_CHECK(!parent.HasChildren() && parent.begin() == parent.end());
+}
+
+ECS_TEST(HierarchyDestroyParentKeepsChildren)
+{
+	ecs::EntityManager manager;
+	ecs::Entity root = manager.CreateEntity();
+	ecs::Entity parent = manager.CreateEntity();
+	std::vector<ecs::Entity> children;
+	root.AddChild(parent);
+	for (int index = 0; index < 3; ++index)
+		parent.AddChild(children.emplace_back(manager.CreateEntity()));
+	ecs::Entity grandchild = manager.CreateEntity();
+	children[1].AddChild(grandchild);
+	parent.Destroy();
+	/* Children survive unparented, their own children stay linked */
+	ECS_CHECK(!parent.IsValid());
+	ECS_CHECK(!root.HasChildren() && root.begin() == root.end());
+	for (auto& child : children)
+		ECS_CHECK(child.IsValid() && !child.HasParent());
+	ECS_CHECK(Children(children[1]) == std::vector<ecs::EntityID>{ grandchild.GetID() });
+	/* Slot of destroyed parent is reused without old links */
+	ecs::Entity entity = manager.CreateEntity();
+	ECS_CHECK(!entity.HasChildren() && !entity.HasParent());
+	children[0].AddChild(entity);
+	ECS_CHECK(Children(children[0]) == std::vector<ecs::EntityID>{ entity.GetID() });
+	ECS_CHECK(children[2].begin() == children[2].end());
+}
+
+namespace
+{
+	struct Local { int Value; };
+	struct World { int Value; };
+	/* Propagate local values, return entities in order they were visited */
+	std::vector<ecs::EntityID> Propagate(ecs::EntityManager& manager)
+	{
+		std::vector<ecs::EntityID> visited;
+		manager.HierarchyEach<Local, World>([&visited](ecs::Entity& entity, const Local& local, World& world, const World* parent)
+		{
+			visited.push_back(entity.GetID());
+			world.Value = local.Value + (parent ? parent->Value : 0);
+		});
+		return visited;
+	}
+	/* Return true if parent of every visited entity was visited before it */
+	bool ParentsFirst(ecs::EntityManager& manager, const std::vector<ecs::EntityID>& visited)
+	{
+		for (auto position = visited.cbegin(); position != visited.cend(); ++position)
+		{
+			const ecs::Entity parent = ecs::Entity(*position, &manager).GetParent();
+			if (parent.IsValid() && std::find(visited.cbegin(), position, parent.GetID()) == position)
+				return false;
+		}
+		return true;
+	}
+}
+
+ECS_TEST(HierarchyEachAfterReparent)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 6; ++index)
+	{
+		auto& entity = entities.emplace_back(manager.CreateEntity());
+		entity.AddComponent<Local>(1 << index);
+		entity.AddComponent<World>(0);
+	}
+	/* 0 is child of 5 created after it, 1 is child of 0, 2 and 3 are children of 5, 4 is unlinked */
+	entities[5].AddChild(entities[0]);
+	entities[0].AddChild(entities[1]);
+	entities[5].AddChild(entities[2]);
+	entities[5].AddChild(entities[3]);
+	auto visited = Propagate(manager);
+	ECS_CHECK(visited.size() == entities.size() && ParentsFirst(manager, visited));
+	ECS_CHECK(entities[1].GetComponent<World>().Value == 0b100011);
+	ECS_CHECK(entities[4].GetComponent<World>().Value == 0b10000);
+
+	/* 0 becomes root, 5 becomes child of 1 and 2 moves under 3, cached order is rebuilt */
+	entities[0].UnsetParent();
+	entities[1].AddChild(entities[5]);
+	entities[2].SetParent(entities[3]);
+	visited = Propagate(manager);
+	ECS_CHECK(visited.size() == entities.size() && ParentsFirst(manager, visited));
+	for (const auto& entity : entities)
+		ECS_CHECK(std::count(visited.cbegin(), visited.cend(), entity.GetID()) == 1);
+	ECS_CHECK(entities[0].GetComponent<World>().Value == 0b1);
+	ECS_CHECK(entities[5].GetComponent<World>().Value == 0b100011);
+	ECS_CHECK(entities[3].GetComponent<World>().Value == 0b101011);
+	ECS_CHECK(entities[2].GetComponent<World>().Value == 0b101111);
+	ECS_CHECK(entities[4].GetComponent<World>().Value == 0b10000);
+
+	/* Unlinked entities are still visited once */
+	entities[1].RemoveChildren();
+	visited = Propagate(manager);
+	ECS_CHECK(visited.size() == entities.size() && ParentsFirst(manager, visited));
+	ECS_CHECK(entities[5].GetComponent<World>().Value == 0b100000);
+	ECS_CHECK(entities[2].GetComponent<World>().Value == 0b101100);
+}
@@ -0,0 +1,68 @@
+#include "Test.h"
+
+/* Stages of scheduler built from declared component access */
+
+namespace
+{
+	struct A { int Value; };
+	struct B { int Value; };
+	struct C { int Value; };
+}
+
+ECS_TEST(SchedulerLevelsConflictingSystems)
+{
+	ecs::EntityManager manager;
+	ecs::Scheduler scheduler(manager);
+	std::vector<int> order;
+	std::mutex mutex;
+	const auto task = [&order, &mutex](const int& index) { return [&order, &mutex, index](ecs::EntityManager&) { std::lock_guard<std::mutex> lock(mutex); order.push_back(index); }; };
+	scheduler.AddTask(ecs::Read<>{}, ecs::Write<A>{}, task(0));
+	/* Readers of A wait for its writer and share stage with each other */
+	scheduler.AddTask(ecs::Read<A>{}, ecs::Write<>{}, task(1));
+	scheduler.AddTask(ecs::Read<A>{}, ecs::Write<>{}, task(2));
+	/* Disjoint system shares first stage */
+	scheduler.AddTask(ecs::Read<>{}, ecs::Write<B>{}, task(3));
+	/* Second writer of A waits for all readers */
+	scheduler.AddTask(ecs::Read<>{}, ecs::Write<A>{}, task(4));
+	/* Reader of B waits for writer of B only */
+	scheduler.AddTask(ecs::Read<B>{}, ecs::Write<C>{}, task(5));
+	/* Writers of C are serialised */
+	scheduler.AddTask(ecs::Read<>{}, ecs::Write<C>{}, task(6));
+
+	const std::vector<std::vector<std::size_t>> expected = { { 0u, 3u }, { 1u, 2u, 5u }, { 4u, 6u } };
+	ECS_CHECK(scheduler.GetStages() == expected);
+	ECS_CHECK(scheduler.GetSystemsCount() == 7u);
+
+	scheduler.Update();
+	ECS_CHECK(order.size() == 7u);
+	/* Stages run one after another */
+	const auto stageOf = [&expected](const int& index)
+	{
+		for (std::size_t stage = 0; stage < expected.size(); ++stage)
+		{
+			if (std::find(expected[stage].cbegin(), expected[stage].cend(), static_cast<std::size_t>(index)) != expected[stage].cend())
+				return stage;
+		}
+		return expected.size();
+	};
+	ECS_CHECK(std::is_sorted(order.cbegin(), order.cend(), [&stageOf](const int& left, const int& right) { return stageOf(left) < stageOf(right); }));
+}
+
+ECS_TEST(SchedulerSystemsUpdateComponents)
+{
+	ecs::EntityManager manager;
+	for (int index = 0; index < 100; ++index)
+	{
+		ecs::Entity entity = manager.CreateEntity();
+		entity.AddComponent<A>(index);
+		entity.AddComponent<B>(0);
+	}
+	ecs::Scheduler scheduler(manager);
+	scheduler.AddSystem(ecs::Read<>{}, ecs::Write<A>{}, [](ecs::Entity&, A& a) { a.Value *= 2; });
+	scheduler.AddSystem(ecs::Read<A>{}, ecs::Write<B>{}, [](ecs::Entity&, const A& a, B& b) { b.Value = a.Value + 1; });
+	ECS_CHECK(scheduler.GetStages().size() == 2u);
+	scheduler.Update();
+	bool updated = true;
+	manager.View<A, B>().Each([&updated](ecs::Entity& entity, A& a, B& b) { updated = updated && a.Value == static_cast<int>(entity.GetID()) * 2 && b.Value == a.Value + 1; });
+	ECS_CHECK(updated);
+}
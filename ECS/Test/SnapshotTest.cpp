@@ -0,0 +1,303 @@
+#include <filesystem>
+#include <fstream>
+#include "Test.h"
+
+/* Snapshots loaded into other manager, and delta between snapshot of one manager and its later state applied to other manager */
+
+namespace
+{
+	/* Raw component stored by value */
+	struct Transform { float X, Y; };
+	/* Raw component with stable references */
+	struct Anchor { int Value; };
+	/* Component written by its serializer */
+	struct Name { std::string Value; };
+	void SaveComponent(std::ostream& stream, const Name& name)
+	{
+		ecs::internal::Write(stream, static_cast<std::uint64_t>(name.Value.size()));
+		stream.write(name.Value.data(), static_cast<std::streamsize>(name.Value.size()));
+	}
+	void LoadComponent(std::istream& stream, Name& name)
+	{
+		std::uint64_t size = 0u;
+		ecs::internal::Read(stream, size);
+		name.Value.resize(static_cast<std::size_t>(size));
+		stream.read(name.Value.data(), static_cast<std::streamsize>(size));
+	}
+	/* Component which can't be serialized */
+	struct Cache { std::vector<int> Values; };
+
+	std::string Save(const ecs::EntityManager& manager)
+	{
+		std::ostringstream stream(std::ios::binary);
+		ecs::Snapshot::Save(manager, stream);
+		return stream.str();
+	}
+	bool Load(ecs::EntityManager& manager, const std::string& snapshot)
+	{
+		std::istringstream stream(snapshot, std::ios::binary);
+		return ecs::Snapshot::Load<Transform, Anchor, Name>(manager, stream);
+	}
+	/* Write snapshot to file in temporary directory and return its path */
+	std::string SaveFile(const ecs::EntityManager& manager)
+	{
+		const auto path = (std::filesystem::temp_directory_path() / "ECSTest.snapshot").string();
+		const auto snapshot = Save(manager);
+		std::ofstream(path, std::ios::binary).write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()));
+		return path;
+	}
+	bool Map(ecs::EntityManager& manager, const std::string& path)
+	{
+		return ecs::Snapshot::Map<Transform, Anchor, Name>(manager, path);
+	}
+	/* Return handles of all valid entities */
+	std::vector<ecs::EntityID> GetHandles(ecs::EntityManager& manager)
+	{
+		std::vector<ecs::EntityID> handles;
+		for (const auto& handle : manager)
+			handles.push_back(handle);
+		return handles;
+	}
+	/* Return true if entities of both managers have the same components */
+	template<typename Component, typename Equal>
+	bool HaveSameComponents(ecs::EntityManager& left, ecs::EntityManager& right, Equal equal)
+	{
+		for (const auto& handle : GetHandles(left))
+		{
+			ecs::Entity first(handle, &left);
+			ecs::Entity second(handle, &right);
+			if (first.HasComponent<Component>() != second.HasComponent<Component>())
+				return false;
+			if (first.HasComponent<Component>() && !equal(first.GetComponent<Component>(), second.GetComponent<Component>()))
+				return false;
+		}
+		return true;
+	}
+	/* Return true if owning group of Transform and Name contains the same entities as view and its rows are aligned */
+	bool GroupMatchesView(ecs::EntityManager& manager)
+	{
+		auto group = manager.Group<Transform, Name>();
+		std::vector<ecs::EntityID> grouped;
+		std::vector<ecs::EntityID> viewed;
+		bool aligned = true;
+		group.Each([&grouped, &aligned](ecs::Entity& entity, Transform& transform, Name& name)
+		{
+			grouped.push_back(entity.GetID());
+			aligned = aligned && std::to_string(static_cast<int>(transform.X)) == name.Value;
+		});
+		manager.View<Transform, Name>().Each([&viewed](ecs::Entity& entity, Transform&, Name&) { viewed.push_back(entity.GetID()); });
+		std::sort(grouped.begin(), grouped.end());
+		std::sort(viewed.begin(), viewed.end());
+		return aligned && group.GetSize() == viewed.size() && grouped == viewed;
+	}
+	/* Fill manager with entities which have Transform, some of them have Name matching it */
+	std::vector<ecs::Entity> CreateNamed(ecs::EntityManager& manager, const int& count)
+	{
+		std::vector<ecs::Entity> entities;
+		for (int index = 0; index < count; ++index)
+		{
+			auto& entity = entities.emplace_back(manager.CreateEntity());
+			entity.AddComponent<Transform>(static_cast<float>(index), 0.f);
+			if (index % 3 != 0)
+				entity.AddComponent<Name>(std::to_string(index));
+		}
+		return entities;
+	}
+}
+
+namespace ecs
+{
+	template<>
+	struct ComponentTraits<Anchor>
+	{
+		static constexpr bool StableReferences = true;
+	};
+}
+
+ECS_TEST(DeltaReplicatesManager)
+{
+	ecs::EntityManager source;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 6; ++index)
+	{
+		auto& entity = entities.emplace_back(source.CreateEntity());
+		entity.AddComponent<Transform>(static_cast<float>(index), 0.f);
+		entity.AddComponent<Anchor>(index);
+		entity.AddComponent<Name>(Name{ "Entity" + std::to_string(index) });
+	}
+	const auto previous = Save(source);
+
+	/* Both managers start from previous snapshot, only the current one is changed */
+	ecs::EntityManager current;
+	ecs::EntityManager replica;
+	ECS_CHECK(Load(current, previous) && Load(replica, previous));
+	const auto destroyed = static_cast<ecs::EntityID>(entities[1]);
+	ecs::Entity(destroyed, &current).Destroy();
+	ecs::Entity recycled = current.CreateEntity();
+	ECS_CHECK(recycled.GetID() == ecs::EntityTraits<ecs::EntityID>::ToID(destroyed) && static_cast<ecs::EntityID>(recycled) != destroyed);
+	recycled.AddComponent<Name>(Name{ "Recycled" });
+	ecs::Entity created = current.CreateEntity();
+	created.AddComponent<Transform>(7.f, 7.f);
+	created.AddComponent<Anchor>(7);
+	ecs::Entity(static_cast<ecs::EntityID>(entities[2]), &current).RemoveComponent<Anchor>();
+	ecs::Entity(static_cast<ecs::EntityID>(entities[2]), &current).RemoveComponent<Name>();
+	ecs::Entity(static_cast<ecs::EntityID>(entities[3]), &current).GetComponent<Transform>().Y = 3.f;
+	ecs::Entity(static_cast<ecs::EntityID>(entities[3]), &current).GetComponent<Anchor>().Value = 30;
+	ecs::Entity(static_cast<ecs::EntityID>(entities[3]), &current).GetComponent<Name>().Value = "Modified";
+	ecs::Entity parent(static_cast<ecs::EntityID>(entities[4]), &current);
+	parent.AddChild(created);
+
+	std::ostringstream delta(std::ios::binary);
+	ECS_CHECK(ecs::Snapshot::SaveDelta(current, previous, delta));
+	std::istringstream stream(delta.str(), std::ios::binary);
+	ECS_CHECK((ecs::Snapshot::ApplyDelta<Transform, Anchor, Name>(replica, stream)));
+
+	ECS_CHECK(GetHandles(replica) == GetHandles(current));
+	ECS_CHECK(!ecs::Entity(destroyed, &replica).IsValid());
+	ECS_CHECK(ecs::Entity(static_cast<ecs::EntityID>(recycled), &replica).IsValid());
+	ECS_CHECK(ecs::Entity(static_cast<ecs::EntityID>(created), &replica).IsChildOf(ecs::Entity(static_cast<ecs::EntityID>(parent), &replica)));
+	ECS_CHECK(HaveSameComponents<Transform>(current, replica, [](const Transform& left, const Transform& right) { return left.X == right.X && left.Y == right.Y; }));
+	ECS_CHECK(HaveSameComponents<Anchor>(current, replica, [](const Anchor& left, const Anchor& right) { return left.Value == right.Value; }));
+	ECS_CHECK(HaveSameComponents<Name>(current, replica, [](const Name& left, const Name& right) { return left.Value == right.Value; }));
+	/* Free list is replicated, so next created entities get the same handles */
+	ECS_CHECK(static_cast<ecs::EntityID>(current.CreateEntity()) == static_cast<ecs::EntityID>(replica.CreateEntity()));
+}
+
+ECS_TEST(DeltaWithoutChanges)
+{
+	ecs::EntityManager source;
+	source.CreateEntity().AddComponent<Name>(Name{ "Entity" });
+	const auto previous = Save(source);
+	std::ostringstream delta(std::ios::binary);
+	ECS_CHECK(ecs::Snapshot::SaveDelta(source, previous, delta));
+	ecs::EntityManager replica;
+	ECS_CHECK(Load(replica, previous));
+	std::istringstream stream(delta.str(), std::ios::binary);
+	ECS_CHECK((ecs::Snapshot::ApplyDelta<Transform, Anchor, Name>(replica, stream)));
+	ECS_CHECK(GetHandles(replica) == GetHandles(source));
+	ECS_CHECK(HaveSameComponents<Name>(source, replica, [](const Name& left, const Name& right) { return left.Value == right.Value; }));
+}
+
+#if defined(NDEBUG)
+ECS_TEST(DeltaRefusesComponentsWhichCantBeSerialized)
+{
+	ecs::EntityManager source;
+	const auto previous = Save(source);
+	source.CreateEntity().AddComponent<Cache>();
+	std::ostringstream delta(std::ios::binary);
+	ECS_CHECK(!ecs::Snapshot::SaveDelta(source, previous, delta));
+	ECS_CHECK(delta.str().empty());
+}
+#endif
+
+ECS_TEST(LoadRebuildsOwningGroup)
+{
+	ecs::EntityManager source;
+	const auto entities = CreateNamed(source, 12);
+	/* Name pool is loaded after Transform pool, group is rebuilt for each of them */
+	ecs::EntityManager target;
+	ECS_CHECK(target.Group<Transform, Name>().IsEmpty());
+	ECS_CHECK(Load(target, Save(source)));
+	ECS_CHECK(target.Group<Transform, Name>().GetSize() == 8u);
+	ECS_CHECK(GroupMatchesView(target));
+	/* Loaded group follows later structural changes */
+	ecs::Entity first(entities[0].GetID(), &target);
+	first.AddComponent<Name>("0");
+	ecs::Entity second(entities[1].GetID(), &target);
+	second.RemoveComponent<Transform>();
+	ECS_CHECK(target.Group<Transform, Name>().GetSize() == 8u);
+	ECS_CHECK(GroupMatchesView(target));
+}
+
+ECS_TEST(MapIsCopyOnWrite)
+{
+	ecs::EntityManager source;
+	const auto entities = CreateNamed(source, 12);
+	const auto path = SaveFile(source);
+	ecs::EntityManager first;
+	ECS_CHECK(Map(first, path));
+	ECS_CHECK(HaveSameComponents<Transform>(source, first, [](const Transform& left, const Transform& right) { return left.X == right.X && left.Y == right.Y; }));
+	/* Writes to adopted components stay in private copy of mapping */
+	ecs::Entity entity(entities[5].GetID(), &first);
+	entity.GetComponent<Transform>().Y = 5.f;
+	ecs::EntityManager second;
+	ECS_CHECK(Map(second, path));
+	ECS_CHECK(ecs::Entity(entities[5].GetID(), &second).GetComponent<Transform>().Y == 0.f);
+	ECS_CHECK(entity.GetComponent<Transform>().Y == 5.f);
+	std::filesystem::remove(path);
+}
+
+ECS_TEST(MapGrowsOutOfMapping)
+{
+	ecs::EntityManager source;
+	const auto entities = CreateNamed(source, 12);
+	const auto path = SaveFile(source);
+	ecs::EntityManager target;
+	ECS_CHECK(Map(target, path));
+	std::filesystem::remove(path);
+	/* Adopted array has no spare capacity, so next component reallocates it into own memory */
+	const Transform* adopted = &ecs::Entity(entities[0].GetID(), &target).GetComponent<Transform>();
+	ecs::Entity entity = target.CreateEntity();
+	entity.AddComponent<Transform>(12.f, 1.f);
+	const Transform* own = &ecs::Entity(entities[0].GetID(), &target).GetComponent<Transform>();
+	ECS_CHECK(adopted != own);
+	ECS_CHECK(HaveSameComponents<Transform>(source, target, [](const Transform& left, const Transform& right) { return left.X == right.X && left.Y == right.Y; }));
+	ECS_CHECK(entity.GetComponent<Transform>().X == 12.f && entity.GetComponent<Transform>().Y == 1.f);
+}
+
+ECS_TEST(MapAdoptsRawPools)
+{
+	ecs::EntityManager source;
+	CreateNamed(source, 12);
+	const auto path = SaveFile(source);
+	ecs::test::CountingResource loadedResource;
+	ecs::test::CountingResource mappedResource;
+	ecs::EntityManager loaded(&loadedResource);
+	ecs::EntityManager mapped(&mappedResource);
+	std::ifstream stream(path, std::ios::binary);
+	ECS_CHECK(ecs::Snapshot::Load<Transform, Anchor, Name>(loaded, stream));
+	ECS_CHECK(Map(mapped, path));
+	std::filesystem::remove(path);
+	/* Only entities and components of Transform pool aren't allocated, they stay in mapping */
+	ECS_CHECK(loadedResource.GetAllocated() - mappedResource.GetAllocated() == 12u * (sizeof(Transform) + sizeof(ecs::EntityID)));
+	ECS_CHECK(HaveSameComponents<Transform>(loaded, mapped, [](const Transform& left, const Transform& right) { return left.X == right.X; }));
+}
+
+ECS_TEST(MapLoadsPoolsWhichCantBeAdopted)
+{
+	ecs::EntityManager source;
+	auto entities = CreateNamed(source, 12);
+	for (std::size_t index = 0; index < entities.size(); index += 2u)
+		entities[index].AddComponent<Anchor>(static_cast<int>(index));
+	const auto path = SaveFile(source);
+	ecs::EntityManager target;
+	ECS_CHECK(Map(target, path));
+	std::filesystem::remove(path);
+	/* Serialized and stable components are read from mapping like from any stream */
+	ECS_CHECK(HaveSameComponents<Name>(source, target, [](const Name& left, const Name& right) { return left.Value == right.Value; }));
+	ECS_CHECK(HaveSameComponents<Anchor>(source, target, [](const Anchor& left, const Anchor& right) { return left.Value == right.Value; }));
+	ECS_CHECK(HaveSameComponents<Transform>(source, target, [](const Transform& left, const Transform& right) { return left.X == right.X; }));
+}
+
+ECS_TEST(MapRebuildsOwningGroup)
+{
+	ecs::EntityManager source;
+	const auto entities = CreateNamed(source, 12);
+	const auto path = SaveFile(source);
+	/* Adopted Transform pool is reordered in private copy of mapping, Name pool is loaded */
+	ecs::EntityManager target;
+	target.Group<Transform, Name>();
+	ECS_CHECK(Map(target, path));
+	ECS_CHECK(target.Group<Transform, Name>().GetSize() == 8u);
+	ECS_CHECK(GroupMatchesView(target));
+	ecs::Entity(entities[3].GetID(), &target).AddComponent<Name>("3");
+	ECS_CHECK(target.Group<Transform, Name>().GetSize() == 9u);
+	ECS_CHECK(GroupMatchesView(target));
+	/* Snapshot file keeps order of source */
+	ecs::EntityManager other;
+	ECS_CHECK(Map(other, path));
+	std::filesystem::remove(path);
+	const auto data = other.View<Transform>().begin();
+	ECS_CHECK(data != other.View<Transform>().end() && data->GetID() == entities[0].GetID());
+	ECS_CHECK(HaveSameComponents<Transform>(source, target, [](const Transform& left, const Transform& right) { return left.X == right.X; }));
+}
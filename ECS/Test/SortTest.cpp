@@ -0,0 +1,143 @@
+#include "Test.h"
+
+/* Sorting of pools, entities and components are moved together */
+
+namespace
+{
+	struct Depth { int Value; };
+	/* Component which can be made from entity id */
+	struct Owner
+	{
+		Owner(const ecs::EntityID& value = 0u) : Value(value) {}
+		ecs::EntityID Value;
+	};
+	struct Score { int Value; };
+	using Pool = ecs::ComponentStorage<Depth, ecs::EntityID>;
+	/* Return true if pool is sorted by depth and every entity still finds its own component */
+	bool IsSorted(const Pool& pool, const std::vector<int>& depths)
+	{
+		for (std::size_t position = 0; position < pool.GetSize(); ++position)
+		{
+			const auto entity = pool.GetData()[position];
+			if (pool.GetPosition(entity) != position || pool.GetAt(position).Value != depths[entity])
+				return false;
+			if (position != 0u && pool.GetAt(position - 1u).Value > pool.GetAt(position).Value)
+				return false;
+		}
+		return true;
+	}
+}
+
+namespace ecs
+{
+	template<>
+	struct ComponentTraits<Score>
+	{
+		static constexpr bool TrackChanges = true;
+	};
+}
+
+ECS_TEST(SortFallsBackToPermutation)
+{
+	ecs::test::CountingResource resource;
+	Pool pool(&resource);
+	std::vector<int> depths(256u);
+	for (std::size_t entity = 0; entity < depths.size(); ++entity)
+		pool.Add(static_cast<ecs::EntityID>(entity), depths[entity] = static_cast<int>(entity));
+	const auto compare = [](const Depth& left, const Depth& right) { return left.Value < right.Value; };
+
+	/* Last element moves through whole array, it stays within budget of insertion */
+	pool.GetAt(255u).Value = depths[255u] = -1;
+	auto allocations = resource.GetAllocated();
+	pool.Sort(compare);
+	ECS_CHECK(IsSorted(pool, depths));
+	ECS_CHECK(resource.GetAllocated() == allocations);
+
+	/* Reversed order runs out of budget, permutation is sorted from scratch buffer of pool resource */
+	for (std::size_t entity = 0; entity < depths.size(); ++entity)
+		pool.Get(static_cast<ecs::EntityID>(entity)).Value = depths[entity] = static_cast<int>(depths.size() - entity);
+	allocations = resource.GetAllocated();
+	pool.Sort(compare);
+	ECS_CHECK(IsSorted(pool, depths));
+	ECS_CHECK(resource.GetAllocated() == allocations + depths.size() * sizeof(std::size_t));
+
+	/* Budget runs out in the middle of insertion, partly moved elements are sorted by permutation */
+	for (std::size_t entity = 0; entity < depths.size(); ++entity)
+		pool.Get(static_cast<ecs::EntityID>(entity)).Value = depths[entity] = static_cast<int>((entity * 37u) % 101u);
+	pool.Sort(compare);
+	ECS_CHECK(IsSorted(pool, depths));
+}
+
+ECS_TEST(SortByEntityOfComponentMadeFromEntity)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 8; ++index)
+		entities.emplace_back(manager.CreateEntity()).AddComponent<Owner>(ecs::EntityID(7u - static_cast<ecs::EntityID>(index)));
+	/* Components are compared, even though compare could take entities too */
+	manager.Sort<Owner>([](const Owner& left, const Owner& right) { return left.Value < right.Value; });
+	std::vector<ecs::EntityID> values;
+	manager.View<Owner>().Each([&values](ecs::Entity&, Owner& owner) { values.push_back(owner.Value); });
+	ECS_CHECK(values == std::vector<ecs::EntityID>{ 0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u });
+	/* Entities are compared */
+	manager.SortByEntity<Owner>([](const ecs::EntityID& left, const ecs::EntityID& right) { return left < right; });
+	std::vector<ecs::EntityID> ids;
+	values.clear();
+	manager.View<Owner>().Each([&values, &ids](ecs::Entity& entity, Owner& owner) { ids.push_back(entity.GetID()); values.push_back(owner.Value); });
+	ECS_CHECK(std::is_sorted(ids.cbegin(), ids.cend()));
+	ECS_CHECK(values == std::vector<ecs::EntityID>{ 7u, 6u, 5u, 4u, 3u, 2u, 1u, 0u });
+}
+
+ECS_TEST(SortAsPartiallyOverlappingPool)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 24; ++index)
+		entities.emplace_back(manager.CreateEntity());
+	for (std::size_t index = 0; index < 10u; ++index)
+		entities[index].AddComponent<Depth>(static_cast<int>(index));
+	/* Other pool has entities which aren't in sorted pool, and misses some of its entities */
+	for (const auto index : { 8u, 20u, 3u, 12u, 5u, 23u, 0u })
+		entities[index].AddComponent<Score>(static_cast<int>(index));
+	manager.SortAs<Depth, Score>();
+	std::vector<int> depths;
+	bool matches = true;
+	manager.View<Depth>().Each([&depths, &matches](ecs::Entity& entity, Depth& depth)
+	{
+		depths.push_back(depth.Value);
+		matches = matches && depth.Value == static_cast<int>(entity.GetID());
+	});
+	ECS_CHECK(matches && depths.size() == 10u);
+	ECS_CHECK((std::vector<int>(depths.cbegin(), depths.cbegin() + 4) == std::vector<int>{ 8, 3, 5, 0 }));
+	std::sort(depths.begin() + 4, depths.end());
+	ECS_CHECK((std::vector<int>(depths.cbegin() + 4, depths.cend()) == std::vector<int>{ 1, 2, 4, 6, 7, 9 }));
+}
+
+ECS_TEST(SortMovesChangeSlots)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 16; ++index)
+		entities.emplace_back(manager.CreateEntity()).AddComponent<Score>(index);
+	manager.AdvanceTick();
+	for (std::size_t index = 0; index < entities.size(); index += 3u)
+		entities[index].MarkChanged<Score>();
+	const auto changed = manager.GetChanged<Score>().size();
+	/* Reversed order is sorted by permutation, each slot is moved by Swap together with its component */
+	manager.Sort<Score>([](const Score& left, const Score& right) { return left.Value > right.Value; });
+	for (std::size_t index = 0; index < entities.size(); ++index)
+		entities[index].MarkChanged<Score>();
+	ECS_CHECK(manager.GetChanged<Score>().size() == entities.size());
+	/* Entities changed before sort are listed once */
+	for (const auto& entity : entities)
+		ECS_CHECK(std::count(manager.GetChanged<Score>().cbegin(), manager.GetChanged<Score>().cend(), entity.GetID()) == 1);
+	ECS_CHECK(changed == 6u);
+	/* Removal finds positions of sorted entities in lists */
+	for (std::size_t index = 0; index < entities.size(); index += 2u)
+		entities[index].RemoveComponent<Score>();
+	const auto& list = manager.GetChanged<Score>();
+	ECS_CHECK(list.size() == entities.size() / 2u);
+	for (std::size_t index = 1; index < entities.size(); index += 2u)
+		ECS_CHECK(std::count(list.cbegin(), list.cend(), entities[index].GetID()) == 1);
+	ECS_CHECK(manager.GetAdded<Score>().empty());
+}
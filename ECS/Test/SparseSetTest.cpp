@@ -0,0 +1,48 @@
+#include "Test.h"
+
+/* Paged sparse array of SparseSet */
+
+namespace
+{
+	using Set = ecs::SparseSet<ecs::EntityID>;
+}
+
+ECS_TEST(SparseSetPageBoundaries)
+{
+	Set set;
+	const ecs::EntityID last = Set::PageSize - 1u;
+	const ecs::EntityID first = Set::PageSize;
+	set.Push(last);
+	set.Push(first);
+	ECS_CHECK(set.Contains(last) && set.Contains(first));
+	ECS_CHECK(set.Find(last) == 0u && set.Find(first) == 1u);
+	ECS_CHECK(!set.Contains(last - 1u) && !set.Contains(first + 1u));
+	ECS_CHECK(set.Find(first + 1u) == Set::Tombstone);
+	/* Ids far behind allocated pages are neither contained nor found */
+	ECS_CHECK(!set.Contains(Set::PageSize * 16u) && set.Find(Set::PageSize * 16u) == Set::Tombstone);
+	ECS_CHECK(set.GetMemoryUsage().Pages == 2u);
+}
+
+ECS_TEST(SparseSetReleasesEmptyPage)
+{
+	Set set;
+	const ecs::EntityID first = Set::PageSize;
+	set.Push(0u);
+	set.Push(first);
+	set.Push(first + 1u);
+	ECS_CHECK(set.GetMemoryUsage().Pages == 2u);
+	set.Pop(first);
+	ECS_CHECK(set.GetMemoryUsage().Pages == 2u);
+	/* Last entry of page is removed, page is released and lookups read shared tombstone page */
+	set.Pop(first + 1u);
+	ECS_CHECK(set.GetMemoryUsage().Pages == 1u);
+	ECS_CHECK(!set.Contains(first) && !set.Contains(first + 1u));
+	ECS_CHECK(set.Find(first + 1u) == Set::Tombstone);
+	ECS_CHECK(set.Contains(0u) && set.GetPosition(0u) == 0u);
+	/* Page is allocated again on next push */
+	set.Push(first + 1u);
+	ECS_CHECK(set.GetMemoryUsage().Pages == 2u);
+	ECS_CHECK(set.Contains(first + 1u) && set.GetPosition(first + 1u) == 1u && !set.Contains(first));
+	set.Clear();
+	ECS_CHECK(set.GetMemoryUsage().Pages == 0u && set.GetSize() == 0u && !set.Contains(0u));
+}
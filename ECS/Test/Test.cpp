@@ -0,0 +1,32 @@
+#include "Test.h"
+#include <iostream>
+
+/* Test runner, returns count of failed checks, usage: ECSTest [--filter <substring>] */
+
+void ecs::test::Fail(const char* expression, const char* file, const int& line)
+{
+	std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+	++GetFailures();
+}
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	for (int index = 1; index + 1 < argc; index += 2)
+	{
+		const std::string argument = argv[index];
+		if (argument == "--filter")
+			filter = argv[index + 1];
+	}
+
+	for (const auto& test : ecs::test::GetCases())
+	{
+		if (!filter.empty() && test.Name.find(filter) == std::string::npos)
+			continue;
+
+		const auto failures = ecs::test::GetFailures();
+		test.Body();
+		std::cerr << test.Name << ": " << ((ecs::test::GetFailures() == failures) ? "passed" : "failed") << "\n";
+	}
+	return (ecs::test::GetFailures() == 0u) ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory_resource>
+#include "ECS.h"
+
+namespace ecs::test
+{
+	/* Test function, failed checks are counted by Check */
+	using Function = void(*)();
+	/* Registered test */
+	struct Case
+	{
+		std::string Name;
+		Function Body;
+	};
+	/* Return all registered tests */
+	inline std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+	/* Register test on static initialization */
+	struct Registrar
+	{
+		Registrar(const char* name, Function body) { GetCases().push_back({ name, body }); }
+	};
+	/* Return count of failed checks */
+	inline std::size_t& GetFailures()
+	{
+		static std::size_t failures = 0u;
+		return failures;
+	}
+	/* Report failed check, test continues */
+	void Fail(const char* expression, const char* file, const int& line);
+	/* Memory resource which counts allocations passed to upstream resource */
+	class CountingResource final : public std::pmr::memory_resource
+	{
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept : m_Upstream(upstream) {}
+		/* Count of allocations which weren't released yet */
+		std::size_t GetAllocations() const noexcept { return m_Allocations; }
+		/* Total bytes ever allocated */
+		std::size_t GetAllocated() const noexcept { return m_Allocated; }
+	private:
+		std::pmr::memory_resource* m_Upstream;
+		std::size_t m_Allocations = 0u;
+		std::size_t m_Allocated = 0u;
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			++m_Allocations;
+			m_Allocated += bytes;
+			return m_Upstream->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* data, std::size_t bytes, std::size_t alignment) override
+		{
+			--m_Allocations;
+			m_Upstream->deallocate(data, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+	};
+}
+
+/* Define and register test */
+#define ECS_TEST(Name) \
+	static void Name(); \
+	static const ecs::test::Registrar Name##Registrar(#Name, Name); \
+	static void Name()
+/* Check condition, failure is reported and counted. Condition can contain commas of template arguments */
+#define ECS_CHECK(...) \
+	((__VA_ARGS__) ? void() : ecs::test::Fail(#__VA_ARGS__, __FILE__, __LINE__))
@@ -0,0 +1,55 @@
+#include "Test.h"
+
+/* Parallel passes on work stealing pool */
+
+namespace
+{
+	struct Value { int Data; };
+}
+
+ECS_TEST(ParallelEachVisitsEachEntityOnce)
+{
+	ecs::EntityManager manager;
+	manager.SetThreadsCount(4u);
+	std::vector<ecs::EntityID> entities;
+	manager.CreateEntities(10000u, std::back_inserter(entities));
+	manager.Insert<Value>(entities.cbegin(), entities.cend(), Value{ 1 });
+	std::vector<std::atomic<int>> visits(entities.size());
+	for (const auto deterministic : { false, true })
+	{
+		for (auto& count : visits)
+			count = 0;
+		manager.View<Value>().ParallelEach([&visits](ecs::Entity& entity, Value&) { visits[entity.GetID()].fetch_add(1); }, { 64u, deterministic });
+		ECS_CHECK(std::all_of(visits.cbegin(), visits.cend(), [](const auto& count) { return count.load() == 1; }));
+	}
+}
+
+ECS_TEST(DeterministicPolicyPinsChunks)
+{
+	ecs::ThreadPool pool(4u);
+	constexpr std::size_t chunks = 64u;
+	std::vector<std::size_t> first(chunks);
+	std::vector<std::size_t> second(chunks);
+	for (auto* workers : { &first, &second })
+	{
+		pool.ParallelFor(chunks * 16u, { 16u, true }, [&pool, workers](const std::size_t& begin, const std::size_t& end)
+			{
+				(*workers)[begin / 16u] = pool.GetWorkerIndex();
+				ECS_CHECK(end - begin == 16u);
+			});
+	}
+	ECS_CHECK(first == second);
+	for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+		ECS_CHECK(first[chunk] == chunk % pool.GetWorkersCount());
+}
+
+ECS_TEST(NestedParallelFor)
+{
+	ecs::ThreadPool pool(3u);
+	std::atomic<std::size_t> sum = 0u;
+	pool.ParallelFor(8u, { 1u, false }, [&pool, &sum](const std::size_t&, const std::size_t&)
+		{
+			pool.ParallelFor(100u, { 10u, false }, [&sum](const std::size_t& begin, const std::size_t& end) { sum += end - begin; });
+		});
+	ECS_CHECK(sum == 800u);
+}
@@ -0,0 +1,36 @@
+#include "Test.h"
+
+/* Names and hashes of types, they are stable across builds of the same compiler */
+
+namespace outer::inner
+{
+	template<typename First, typename Second>
+	struct Holder {};
+	struct Plain {};
+}
+
+ECS_TEST(TypeNameOfNamespacedTemplate)
+{
+	using Type = outer::inner::Holder<int[2], std::pair<int, float>>;
+	/* Template argument with ']' isn't cut */
+#if defined(_MSC_VER) && !defined(__clang__)
+	constexpr std::string_view expected = "outer::inner::Holder<int [2],struct std::pair<int,float> >";
+#elif defined(__clang__)
+	constexpr std::string_view expected = "outer::inner::Holder<int[2], std::pair<int, float>>";
+#else
+	constexpr std::string_view expected = "outer::inner::Holder<int [2], std::pair<int, float> >";
+	static_assert(ecs::TypeInfo<Type>::Hash() == 0xc714f510ed4de527ull, "Hash of type changed !");
+#endif
+	static_assert(ecs::TypeInfo<Type>::Name() == expected, "Name of type changed !");
+	ECS_CHECK(ecs::TypeInfo<Type>::Name() == expected);
+	ECS_CHECK(ecs::TypeInfo<Type>::Hash() == ecs::internal::Fnv1a(expected));
+	ECS_CHECK(ecs::TypeInfo<outer::inner::Plain>::Name() == "outer::inner::Plain");
+	ECS_CHECK(ecs::TypeInfo<outer::inner::Plain>::Hash() != ecs::TypeInfo<Type>::Hash());
+}
+
+ECS_TEST(TypeHashIsFnv1a)
+{
+	static_assert(ecs::internal::Fnv1a("") == 0xcbf29ce484222325ull, "FNV-1a offset basis changed !");
+	ECS_CHECK(ecs::internal::Fnv1a("a") == 0xaf63dc4c8601ec8cull);
+	ECS_CHECK(ecs::internal::Fnv1a("foobar") == 0x85944171f73967e8ull);
+}
@@ -0,0 +1,105 @@
+#include "Test.h"
+
+/* Views with excluded and optional components */
+
+namespace
+{
+	struct A { int Value; };
+	struct B { int Value; };
+	struct C { int Value; };
+	struct D { int Value; };
+	/* Return values of A of entities visited by each way of iteration, or empty list if they differ */
+	template<typename View>
+	std::vector<int> Visit(View view)
+	{
+		std::vector<int> each, iterated;
+		view.Each([&each](ecs::Entity&, A& a, auto&&...) { each.push_back(a.Value); });
+		for (auto& entity : view)
+			iterated.push_back(entity.template GetComponent<A>().Value);
+		std::sort(each.begin(), each.end());
+		std::sort(iterated.begin(), iterated.end());
+		return (each == iterated) ? each : std::vector<int>{};
+	}
+}
+
+ECS_TEST(ViewExcludesComponents)
+{
+	ecs::EntityManager manager;
+	for (int index = 0; index < 10; ++index)
+	{
+		ecs::Entity entity = manager.CreateEntity();
+		entity.AddComponent<A>(index);
+		if (index % 2 == 0)
+			entity.AddComponent<B>(index);
+		if (index % 3 == 0)
+			entity.AddComponent<C>(index);
+	}
+	ECS_CHECK(Visit(manager.View<A>(ecs::Exclude<B>{})) == std::vector<int>{ 1, 3, 5, 7, 9 });
+	ECS_CHECK(Visit(manager.View<A>(ecs::Exclude<B, C>{})) == std::vector<int>{ 1, 5, 7 });
+	ECS_CHECK(Visit(manager.View<A, C>(ecs::Exclude<B>{})) == std::vector<int>{ 3, 9 });
+	std::vector<int> chunked;
+	manager.View<A>(ecs::Exclude<B, C>{}).EachChunk([&chunked](const ecs::Span<const ecs::EntityID>&, const ecs::Span<A>& as)
+	{
+		for (const auto& a : as)
+			chunked.push_back(a.Value);
+	});
+	std::sort(chunked.begin(), chunked.end());
+	ECS_CHECK(chunked == std::vector<int>{ 1, 5, 7 });
+}
+
+ECS_TEST(ViewExcludesMissingPool)
+{
+	ecs::EntityManager manager;
+	for (int index = 0; index < 4; ++index)
+		manager.CreateEntity().AddComponent<A>(index);
+	/* Pool of excluded component doesn't exist, nothing is excluded */
+	ECS_CHECK(!manager.HasComponentPool<B>());
+	ECS_CHECK(Visit(manager.View<A>(ecs::Exclude<B>{})) == std::vector<int>{ 0, 1, 2, 3 });
+	ECS_CHECK(!manager.HasComponentPool<B>());
+}
+
+ECS_TEST(ViewCandidateIgnoresExcludedPools)
+{
+	ecs::EntityManager manager;
+	std::vector<ecs::Entity> entities;
+	for (int index = 0; index < 6; ++index)
+		entities.emplace_back(manager.CreateEntity()).AddComponent<A>(index);
+	entities[0].AddComponent<B>(0);
+	/* Excluded pool is the smallest one, but it isn't candidate */
+	ECS_CHECK(Visit(manager.View<A>(ecs::Exclude<B>{})) == std::vector<int>{ 1, 2, 3, 4, 5 });
+	entities[0].RemoveComponent<B>();
+	ECS_CHECK(manager.HasComponentPool<B>());
+	ECS_CHECK(Visit(manager.View<A>(ecs::Exclude<B>{})) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+	/* Optional pools aren't candidate either */
+	ECS_CHECK(Visit(manager.View<A, ecs::Optional<B>>()) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+}
+
+ECS_TEST(ViewOptionalComponents)
+{
+	ecs::EntityManager manager;
+	for (int index = 0; index < 6; ++index)
+	{
+		ecs::Entity entity = manager.CreateEntity();
+		entity.AddComponent<A>(index);
+		if (index % 2 == 0)
+			entity.AddComponent<B>(index * 10);
+		if (index == 4)
+			entity.AddComponent<C>(index);
+	}
+	bool matches = true;
+	std::size_t count = 0;
+	manager.View<A, ecs::Optional<B>>(ecs::Exclude<C>{}).Each([&matches, &count](ecs::Entity&, A& a, B* b)
+	{
+		++count;
+		matches = matches && (a.Value % 2 == 0 ? (b && b->Value == a.Value * 10) : b == nullptr);
+	});
+	ECS_CHECK(matches && count == 5u);
+	/* Optional component which has no pool is always null */
+	count = 0;
+	manager.View<B, ecs::Optional<A>, ecs::Optional<C>, ecs::Optional<D>>().Each([&matches, &count](ecs::Entity&, B& b, A* a, C* c, D* d)
+	{
+		++count;
+		matches = matches && a && a->Value * 10 == b.Value && (c != nullptr) == (a->Value == 4) && d == nullptr;
+	});
+	ECS_CHECK(matches && count == 3u);
+}